@@ -0,0 +1,639 @@
+
+// Chain of Responsibility with an Asynchronous Logging Backend:
+// In the classic chain every processor writes to cout with endl, so each message flushes and the
+// calling thread waits for the terminal or disk. Here the processors hand their records to an
+// AsyncLogBackend instead. Every logging thread gets its own lock-free single-producer ring buffer
+// per backend, freed once the thread has exited and the ring is drained, and one background writer
+// thread drains all rings and emits the text in large write() calls. When a ring is full the
+// backend either blocks the caller until space frees up or drops the record and counts it.
+// Optionally an ERROR record is only returned from once it has been written out.
+#include <bits/stdc++.h>
+#include <fcntl.h>
+#include <unistd.h>
+using namespace std;
+
+/**
+ * A fixed-size log record as stored in a ring buffer. Messages longer than MAX_MESSAGE are cut.
+ */
+struct LogRecord{
+    static const int MAX_MESSAGE = 240;
+
+    int level;
+    const char *label;          // Static text such as "ERROR"
+    uint32_t length;
+    char message[MAX_MESSAGE];
+};
+
+/**
+ * A bounded single-producer single-consumer ring buffer. The owning logging thread is the only
+ * producer and the writer thread the only consumer, so head and tail are each written by a single
+ * thread and plain acquire/release ordering is enough.
+ */
+class LogRing{
+    vector<LogRecord> slots;
+    size_t mask;
+    alignas(64) atomic<size_t> head;  // Next slot to fill, written by the producer
+    alignas(64) atomic<size_t> tail;  // Next slot to drain, written by the consumer
+    atomic<bool> retired;             // Set when the producing thread exits
+
+    public:
+    LogRing(size_t capacity): slots(capacity), mask(capacity - 1), head(0), tail(0), retired(false){
+        assert((capacity & mask) == 0 && "capacity must be a power of two");
+    }
+
+/**
+ * Copy a record into the ring.
+ *
+ * @return The sequence number of the record, or -1 if the ring is full.
+ */
+    long long tryPush(int level, const char *label, string_view message){
+        size_t h = head.load(memory_order_relaxed);
+        if(h - tail.load(memory_order_acquire) == slots.size()){
+            return -1;
+        }
+        LogRecord &record = slots[h & mask];
+        record.level = level;
+        record.label = label;
+        record.length = (uint32_t)min<size_t>(message.size(), LogRecord::MAX_MESSAGE);
+        memcpy(record.message, message.data(), record.length);
+        head.store(h + 1, memory_order_release);
+        return (long long)h;
+    }
+
+/**
+ * @return The records available to the consumer, as [first, last) sequence numbers.
+ */
+    pair<size_t, size_t> readable(){
+        return {tail.load(memory_order_relaxed), head.load(memory_order_acquire)};
+    }
+
+    const LogRecord &at(size_t sequence){
+        return slots[sequence & mask];
+    }
+
+/**
+ * Hand slots back to the producer once their records have been written out.
+ */
+    void release(size_t newTail){
+        tail.store(newTail, memory_order_release);
+    }
+
+/**
+ * @return true once the record with the given sequence number has been written out.
+ */
+    bool isWritten(size_t sequence){
+        return tail.load(memory_order_acquire) > sequence;
+    }
+
+/**
+ * Called by the producer when its thread exits; it pushes nothing afterwards.
+ */
+    void retire(){
+        retired.store(true, memory_order_release);
+    }
+
+    bool isRetired(){
+        return retired.load(memory_order_acquire);
+    }
+};
+
+/**
+ * The AsyncLogBackend owns the per-thread rings and the writer thread.
+ */
+class AsyncLogBackend{
+    public:
+    enum OverflowPolicy{ BLOCK, DROP };
+
+    private:
+    static const size_t BATCH_BYTES = 64 * 1024;
+
+    long long id;
+    int fd;
+    size_t ringCapacity;
+    OverflowPolicy policy;
+    bool flushOnError;
+    int errorLevel;
+
+    mutex registryMutex;               // Only taken when a thread logs for the first time
+    vector<shared_ptr<LogRing>> rings; // Shared with the producing threads, see ThreadRings
+    atomic<long long> ringsVersion;    // Bumped whenever a ring is added or removed
+    atomic<long long> dropped;
+    atomic<long long> writeCalls;
+    atomic<long long> writeErrors;
+    atomic<long long> bytesLost;
+    atomic<bool> stopping;
+    thread writer;
+
+/**
+ * The rings one thread produces into, one per backend it has logged through. Backends are told
+ * apart by id rather than address, since a new backend may reuse the address of a destroyed one.
+ * The rings are held weakly: when the thread exits it retires each ring whose backend still
+ * exists, and the writer frees it once drained. Entries of destroyed backends are dropped.
+ */
+    struct ThreadRings{
+        struct Entry{
+            long long backendId;
+            weak_ptr<LogRing> ring;
+            LogRing *raw;    // Valid while the backend lives; only the writer removes rings
+        };
+        vector<Entry> entries;
+        size_t last = 0;     // Entry used most recently, checked first
+
+        ~ThreadRings(){
+            for(auto &entry : entries){
+                if(auto ring = entry.ring.lock()){
+                    ring->retire();
+                }
+            }
+        }
+    };
+
+    LogRing *ringForThisThread(){
+        thread_local ThreadRings mine;
+        if(mine.last < mine.entries.size() && mine.entries[mine.last].backendId == id){
+            return mine.entries[mine.last].raw;
+        }
+        for(size_t i = 0; i < mine.entries.size(); i++){
+            if(mine.entries[i].backendId == id){
+                mine.last = i;
+                return mine.entries[i].raw;
+            }
+        }
+        mine.entries.erase(remove_if(mine.entries.begin(), mine.entries.end(), [](const ThreadRings::Entry &entry){
+            return entry.ring.expired();
+        }), mine.entries.end());
+        shared_ptr<LogRing> ring = make_shared<LogRing>(ringCapacity);
+        {
+            lock_guard<mutex> lock(registryMutex);
+            rings.push_back(ring);
+            ringsVersion.fetch_add(1, memory_order_release);
+        }
+        mine.entries.push_back({id, ring, ring.get()});
+        mine.last = mine.entries.size() - 1;
+        return ring.get();
+    }
+
+/**
+ * Write the whole batch, retrying interrupted and partial writes. Any other failure is counted,
+ * and the unwritten rest of the batch is counted as lost.
+ */
+    void writeAll(string &batch){
+        size_t offset = 0;
+        while(offset < batch.size()){
+            ssize_t n = ::write(fd, batch.data() + offset, batch.size() - offset);
+            if(n < 0 && errno == EINTR){
+                continue;
+            }
+            if(n <= 0){
+                writeErrors.fetch_add(1, memory_order_relaxed);
+                bytesLost.fetch_add((long long)(batch.size() - offset), memory_order_relaxed);
+                break;
+            }
+            offset += (size_t)n;
+        }
+        writeCalls.fetch_add(1, memory_order_relaxed);
+        batch.clear();
+    }
+
+/**
+ * Free the rings whose threads have exited and whose records have all been written.
+ */
+    void removeRetired(vector<LogRing*> &finished){
+        lock_guard<mutex> lock(registryMutex);
+        rings.erase(remove_if(rings.begin(), rings.end(), [&](const shared_ptr<LogRing> &ring){
+            return find(finished.begin(), finished.end(), ring.get()) != finished.end();
+        }), rings.end());
+        ringsVersion.fetch_add(1, memory_order_release);
+    }
+
+/**
+ * Drain every ring into one text buffer, write it, and only then give the slots back. Releasing
+ * after the write is what lets flush-on-ERROR callers know their record reached the file.
+ * @return true if anything was written.
+ */
+    bool drainOnce(string &batch, vector<LogRing*> &known, long long &knownVersion){
+        if(ringsVersion.load(memory_order_acquire) != knownVersion){
+            lock_guard<mutex> lock(registryMutex);
+            knownVersion = ringsVersion.load();
+            known.clear();
+            for(auto &ring : rings){
+                known.push_back(ring.get());
+            }
+        }
+        vector<pair<LogRing*, size_t>> pending;
+        vector<LogRing*> finished;
+        for(LogRing *ring : known){
+            bool retired = ring->isRetired();  // Checked first: a retired ring gets no new records
+            auto range = ring->readable();
+            size_t sequence = range.first;
+            for(; sequence < range.second; sequence++){
+                const LogRecord &record = ring->at(sequence);
+                batch.append(record.label);
+                batch.push_back(' ');
+                batch.append(record.message, record.length);
+                batch.push_back('\n');
+                if(batch.size() >= BATCH_BYTES){
+                    sequence++;
+                    break;
+                }
+            }
+            if(sequence != range.first){
+                pending.push_back({ring, sequence});
+            }
+            if(retired && sequence == range.second){
+                finished.push_back(ring);
+            }
+            if(batch.size() >= BATCH_BYTES){
+                writeAll(batch);
+                for(auto &p : pending){
+                    p.first->release(p.second);
+                }
+                pending.clear();
+            }
+        }
+        bool wrote = !batch.empty() || !pending.empty();
+        if(!batch.empty()){
+            writeAll(batch);
+        }
+        for(auto &p : pending){
+            p.first->release(p.second);
+        }
+        if(!finished.empty()){
+            removeRetired(finished);
+        }
+        return wrote;
+    }
+
+    void writerLoop(){
+        string batch;
+        batch.reserve(BATCH_BYTES + 512);
+        vector<LogRing*> known;  // Writer's snapshot of the registered rings
+        long long knownVersion = -1;
+        int idleRounds = 0;
+        while(true){
+            bool stop = stopping.load(memory_order_acquire);
+            if(drainOnce(batch, known, knownVersion)){
+                idleRounds = 0;
+                continue;
+            }
+            if(stop){
+                break;
+            }
+            // Back off gradually when there is nothing to write.
+            if(++idleRounds < 64){
+                this_thread::yield();
+            }
+            else{
+                this_thread::sleep_for(chrono::microseconds(50));
+            }
+        }
+    }
+
+    static long long nextId(){
+        static atomic<long long> counter(0);
+        return counter.fetch_add(1);
+    }
+
+    public:
+/**
+ * @param outputFd     File descriptor the writer thread writes to.
+ * @param capacity     Records per thread ring, a power of two.
+ * @param overflow     What log() does when the caller's ring is full.
+ * @param errorFlush   If true, ERROR records block the caller until they have been written.
+ * @param errorLvl     The level treated as ERROR.
+ */
+    AsyncLogBackend(int outputFd, size_t capacity = 4096, OverflowPolicy overflow = BLOCK, bool errorFlush = false, int errorLvl = 3)
+        : id(nextId()), fd(outputFd), ringCapacity(capacity), policy(overflow), flushOnError(errorFlush), errorLevel(errorLvl),
+          ringsVersion(0), dropped(0), writeCalls(0), writeErrors(0), bytesLost(0), stopping(false){
+        writer = thread(&AsyncLogBackend::writerLoop, this);
+    }
+
+/**
+ * Stop the writer after it has written every record already queued. No thread may log after this.
+ */
+    void shutdown(){
+        if(writer.joinable()){
+            stopping.store(true, memory_order_release);
+            writer.join();
+        }
+    }
+
+    ~AsyncLogBackend(){
+        shutdown();
+    }
+
+/**
+ * Queue a record from the calling thread. Lock-free except for the first call on each thread.
+ */
+    void submit(int level, const char *label, string_view message){
+        LogRing *ring = ringForThisThread();
+        long long sequence = ring->tryPush(level, label, message);
+        if(sequence < 0){
+            if(policy == DROP){
+                dropped.fetch_add(1, memory_order_relaxed);
+                return;
+            }
+            while((sequence = ring->tryPush(level, label, message)) < 0){
+                this_thread::yield();
+            }
+        }
+        if(flushOnError && level == errorLevel){
+            while(!ring->isWritten((size_t)sequence)){
+                this_thread::yield();
+            }
+        }
+    }
+
+    long long getDropped(){
+        return dropped.load();
+    }
+
+    long long getWriteCalls(){
+        return writeCalls.load();
+    }
+
+/**
+ * @return Failed write() calls other than EINTR, and the bytes they left unwritten.
+ */
+    pair<long long, long long> getWriteErrors(){
+        return {writeErrors.load(), bytesLost.load()};
+    }
+
+/**
+ * @return The number of live rings: one per thread and backend, until the thread has exited and
+ * its ring has been drained.
+ */
+    size_t getRingCount(){
+        lock_guard<mutex> lock(registryMutex);
+        return rings.size();
+    }
+};
+
+/**
+ * The LogProcessor class is the base class for all log processors in the chain. A processor
+ * with a backend queues its output there; without one it prints to cout like the classic chain.
+ */
+class LogProcessor{
+    protected:
+    LogProcessor *nextLogProcessor;
+    AsyncLogBackend *backend;
+
+    void emit(const int logLevel, const char *label, string_view message){
+        if(backend != NULL){
+            backend->submit(logLevel, label, message);
+        }
+        else{
+            static mutex coutMutex;  // Keeps lines from different threads apart
+            lock_guard<mutex> lock(coutMutex);
+            cout<<label<<" "<<message<<endl;
+        }
+    }
+
+    public:
+    const int INFO = 1;
+    const int DEBUG = 2;
+    const int ERROR = 3;
+
+    LogProcessor(LogProcessor *nlp, AsyncLogBackend *b = NULL): nextLogProcessor(nlp), backend(b){}
+
+    virtual ~LogProcessor(){
+        delete nextLogProcessor;
+    }
+
+/**
+ * Pass a log message to the next processor in the chain, if any. Hop tracing ("going next") is
+ * left out here since it would double the work of every forwarded message.
+ */
+    virtual void log(const int logLevel, const string &message){
+        if(nextLogProcessor!=NULL){
+            nextLogProcessor->log(logLevel, message);
+        }
+    }
+};
+
+class InfoLogProcessor: public LogProcessor{
+    public:
+    InfoLogProcessor(LogProcessor *nlp, AsyncLogBackend *b = NULL): LogProcessor(nlp, b){}
+
+    void log(const int logLevel, const string &message){
+        if(logLevel == INFO){
+            emit(logLevel, "INFO", message);
+        }
+        else{
+            LogProcessor::log(logLevel, message);
+        }
+    }
+};
+
+/**
+ * The DebugLogProcessor class handles log messages with DEBUG level.
+ */
+class DebugLogProcessor: public LogProcessor{
+    public:
+    DebugLogProcessor(LogProcessor *nlp, AsyncLogBackend *b = NULL): LogProcessor(nlp, b){}
+
+    void log(const int logLevel, const string &message){
+        if(logLevel == DEBUG){
+            emit(logLevel, "DEBUG", message);
+        }
+        else{
+            LogProcessor::log(logLevel, message);
+        }
+    }
+};
+
+/**
+ * The ErrorLogProcessor class handles log messages with ERROR level.
+ */
+class ErrorLogProcessor: public LogProcessor{
+    public:
+    ErrorLogProcessor(LogProcessor *nlp, AsyncLogBackend *b = NULL): LogProcessor(nlp, b){}
+
+    void log(const int logLevel, const string &message){
+        if(logLevel == ERROR){
+            emit(logLevel, "ERROR", message);
+        }
+        else{
+            LogProcessor::log(logLevel, message);
+        }
+    }
+};
+
+/**
+ * A log2-bucketed latency histogram for the caller's side of log().
+ */
+class LatencyHistogram{
+    array<long long, 64> buckets;
+    long long count;
+    long long maxNs;
+
+    public:
+    LatencyHistogram(): count(0), maxNs(0){
+        buckets.fill(0);
+    }
+
+    void record(long long ns){
+        int bucket = ns <= 0 ? 0 : 64 - __builtin_clzll((unsigned long long)ns);
+        buckets[bucket]++;
+        count++;
+        maxNs = max(maxNs, ns);
+    }
+
+    void merge(const LatencyHistogram &other){
+        for(int i = 0; i < 64; i++){
+            buckets[i] += other.buckets[i];
+        }
+        count += other.count;
+        maxNs = max(maxNs, other.maxNs);
+    }
+
+/**
+ * @return The upper bound of the bucket holding the given percentile.
+ */
+    long long percentile(double p){
+        long long target = (long long)ceil(count * p / 100.0), seen = 0;
+        for(int i = 0; i < 64; i++){
+            seen += buckets[i];
+            if(seen >= target){
+                return i == 0 ? 0 : (1LL << i);
+            }
+        }
+        return maxNs;
+    }
+
+    void print(const string &name){
+        cout<<name<<": p50<="<<percentile(50)<<"ns p99<="<<percentile(99)<<"ns p99.9<="<<percentile(99.9)
+            <<"ns max="<<maxNs<<"ns"<<endl;
+    }
+};
+
+/**
+ * Log from several threads through a chain and collect the caller-side latency of each call.
+ * Every 100th message is an ERROR, the rest are INFO and DEBUG.
+ */
+LatencyHistogram runThreads(LogProcessor *chain, int threads, int messagesPerThread){
+    vector<LatencyHistogram> histograms(threads);
+    vector<thread> workers;
+    for(int t = 0; t < threads; t++){
+        workers.emplace_back([&, t](){
+            string message = "worker " + to_string(t) + " handled request with status 200 in 3ms";
+            for(int i = 0; i < messagesPerThread; i++){
+                int level = i % 100 == 0 ? chain->ERROR : (i % 2 == 0 ? chain->INFO : chain->DEBUG);
+                auto start = chrono::steady_clock::now();
+                chain->log(level, message);
+                auto end = chrono::steady_clock::now();
+                histograms[t].record(chrono::duration_cast<chrono::nanoseconds>(end - start).count());
+            }
+        });
+    }
+    for(auto &worker : workers){
+        worker.join();
+    }
+    LatencyHistogram total;
+    for(auto &histogram : histograms){
+        total.merge(histogram);
+    }
+    return total;
+}
+
+/**
+ * Compare the synchronous endl-per-message path with the async backend under each policy.
+ * Output goes to /dev/null so the numbers show the logging path rather than the terminal.
+ */
+void benchmark(int threads, int messagesPerThread){
+    int fd = open("/dev/null", O_WRONLY);
+    {
+        // Synchronous baseline: one flushed write per message, serialized by a lock.
+        ofstream file("/dev/null");
+        streambuf *old = cout.rdbuf(file.rdbuf());
+        LogProcessor *chain = new InfoLogProcessor(new DebugLogProcessor(new ErrorLogProcessor(NULL)));
+        LatencyHistogram histogram = runThreads(chain, threads, messagesPerThread);
+        cout.rdbuf(old);
+        histogram.print("sync cout+endl     ");
+        delete chain;
+    }
+    struct Setup{ const char *name; AsyncLogBackend::OverflowPolicy policy; bool flushOnError; };
+    for(Setup setup : {Setup{"async block        ", AsyncLogBackend::BLOCK, false},
+                       Setup{"async drop         ", AsyncLogBackend::DROP, false},
+                       Setup{"async block+errsync", AsyncLogBackend::BLOCK, true}}){
+        AsyncLogBackend *backend = new AsyncLogBackend(fd, 4096, setup.policy, setup.flushOnError);
+        LogProcessor *chain = new InfoLogProcessor(new DebugLogProcessor(new ErrorLogProcessor(NULL, backend), backend), backend);
+        LatencyHistogram histogram = runThreads(chain, threads, messagesPerThread);
+        backend->shutdown(); // Drains the rings before returning
+        histogram.print(setup.name);
+        cout<<"    write() calls="<<backend->getWriteCalls()<<" dropped="<<backend->getDropped()
+            <<" write errors="<<backend->getWriteErrors().first<<endl;
+        delete chain;
+        delete backend;
+    }
+    close(fd);
+}
+
+/**
+ * One thread alternates between two backends. It keeps one ring per backend, so each file gets
+ * its records in order, and both rings are freed after the thread exits.
+ */
+void alternatingBackends(){
+    const int MESSAGES = 20000;
+    string paths[2];
+    int fds[2];
+    for(int b = 0; b < 2; b++){
+        paths[b] = (filesystem::temp_directory_path() / ("async-logging-" + to_string(b) + ".log")).string();
+        fds[b] = open(paths[b].c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    }
+    AsyncLogBackend first(fds[0]), second(fds[1]);
+    LogProcessor *chains[2] = {new InfoLogProcessor(NULL, &first), new InfoLogProcessor(NULL, &second)};
+    size_t ringsWhileRunning = 0;
+    thread producer([&](){
+        for(int i = 0; i < MESSAGES; i++){
+            chains[i % 2]->log(chains[i % 2]->INFO, to_string(i));
+        }
+        ringsWhileRunning = first.getRingCount() + second.getRingCount();
+    });
+    producer.join();
+    for(int wait = 0; wait < 1000 && first.getRingCount() + second.getRingCount() > 0; wait++){
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    size_t ringsAfterExit = first.getRingCount() + second.getRingCount();
+    first.shutdown();
+    second.shutdown();
+
+    bool ordered = true;
+    for(int b = 0; b < 2; b++){
+        ifstream file(paths[b]);
+        string label;
+        int expected = b == 0 ? 0 : 1, value;
+        while(file>>label>>value){
+            ordered = ordered && value == expected;
+            expected += 2;
+        }
+        ordered = ordered && expected - 2 == MESSAGES - 2 + b;
+        close(fds[b]);
+        remove(paths[b].c_str());
+    }
+    cout<<MESSAGES<<" records alternating between two backends: rings while logging="<<ringsWhileRunning
+        <<", after the thread exited="<<ringsAfterExit<<", records in order: "<<(ordered ? "yes" : "NO")<<endl;
+    delete chains[0];
+    delete chains[1];
+}
+
+/**
+ * Log one message of each level through an async chain writing to stdout, then run the
+ * benchmark with 4 threads.
+ */
+int main() {
+    {
+        AsyncLogBackend backend(STDOUT_FILENO);
+        LogProcessor *logProcessor = new InfoLogProcessor(new DebugLogProcessor(new ErrorLogProcessor(NULL, &backend), &backend), &backend);
+        logProcessor->log(logProcessor->INFO, "get info");
+        logProcessor->log(logProcessor->DEBUG, "get debug");
+        logProcessor->log(logProcessor->ERROR, "get error");
+        delete logProcessor;
+    }
+
+    cout<<"--------------"<<endl;
+    alternatingBackends();
+
+    cout<<"--------------"<<endl;
+    benchmark(4, 200000);
+}
@@ -0,0 +1,619 @@
+
+// Chain of Responsibility with Binary Structured Logging:
+// Formatting text inside every log call costs more CPU than the rest of the logging chain. In
+// this variant the processors can write to a BinaryLogSink instead of cout. For every call the
+// sink stores a compact record in a memory-mapped segment file: the id of the call site's format
+// string, the level, a timestamp and the raw argument values. Each format string is written to
+// the segment once, the first time it is used. Turning records back into text happens offline:
+// run this program as `<binary> decode <segment files...>`.
+#include <bits/stdc++.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+using namespace std;
+
+/**
+ * Argument type tags used in the binary encoding.
+ */
+enum ArgType : uint8_t { ARG_INT = 1, ARG_DOUBLE = 2, ARG_STRING = 3 };
+
+/**
+ * Record kinds in a segment. A FORMAT record defines a format id, a LOG record is one log call.
+ */
+enum RecordKind : uint8_t { RECORD_FORMAT = 1, RECORD_LOG = 2 };
+
+/**
+ * Segment file header. `used` counts bytes after the header and is updated after every record, so
+ * a segment can be decoded even if the process died without closing it.
+ */
+struct SegmentHeader{
+    char magic[4];      // "BLOG"
+    uint32_t version;
+    uint64_t used;
+};
+
+/**
+ * Encoding of a single argument. Integers are stored as 8 bytes, floating point values as
+ * doubles and text as a 4-byte length followed by the bytes.
+ */
+template <typename T>
+size_t encodedSize(const T &){
+    static_assert(is_arithmetic<T>::value, "unsupported log argument type");
+    return 1 + 8;
+}
+
+size_t encodedSize(const string &value){
+    return 1 + 4 + value.size();
+}
+
+size_t encodedSize(const char *value){
+    return 1 + 4 + strlen(value);
+}
+
+template <typename T>
+char *encode(char *out, const T &value){
+    if constexpr (is_floating_point<T>::value){
+        double v = value;
+        *out++ = ARG_DOUBLE;
+        memcpy(out, &v, 8);
+    }
+    else{
+        int64_t v = (int64_t)value;
+        *out++ = ARG_INT;
+        memcpy(out, &v, 8);
+    }
+    return out + 8;
+}
+
+char *encodeText(char *out, const char *text, uint32_t length){
+    *out++ = ARG_STRING;
+    memcpy(out, &length, 4);
+    memcpy(out + 4, text, length);
+    return out + 4 + length;
+}
+
+char *encode(char *out, const string &value){
+    return encodeText(out, value.data(), (uint32_t)value.size());
+}
+
+char *encode(char *out, const char *value){
+    return encodeText(out, value, (uint32_t)strlen(value));
+}
+
+/**
+ * The arguments of one log call, which can either be encoded for the binary sink or rendered as
+ * text for the classic cout path.
+ */
+class LogArguments{
+    public:
+    virtual size_t size() const = 0;
+    virtual char *encodeAll(char *out) const = 0;
+    virtual void render(ostream &out, const char *format) const = 0;
+};
+
+template <typename... Args>
+class TypedLogArguments: public LogArguments{
+    tuple<const Args &...> args;
+
+    public:
+    TypedLogArguments(const Args &...a): args(a...){}
+
+    size_t size() const{
+        return apply([](const auto &...a){ return (size_t(0) + ... + encodedSize(a)); }, args);
+    }
+
+    char *encodeAll(char *out) const{
+        apply([&](const auto &...a){ ((out = encode(out, a)), ...); }, args);
+        return out;
+    }
+
+    void render(ostream &out, const char *format) const{
+        const char *rest = format;
+        apply([&](const auto &...a){
+            auto renderOne = [&](const auto &arg){
+                const char *placeholder = strstr(rest, "{}");
+                if(placeholder == NULL){
+                    return;
+                }
+                out.write(rest, placeholder - rest);
+                out<<arg;
+                rest = placeholder + 2;
+            };
+            (void)renderOne;
+            (renderOne(a), ...);
+        }, args);
+        out<<rest;
+    }
+};
+
+/**
+ * Process-wide table of format strings. Each logging call site registers its format once and
+ * keeps the id in a function-local static. Ids are stored in 16 bits, so the table is a fixed
+ * array of 65536 entries that never moves: a reader loads its entry without a lock while other
+ * threads register, and registering beyond the last id throws.
+ */
+class FormatRegistry{
+    static const size_t MAX_FORMATS = 1 << 16;
+
+    static atomic<const char*> *table(){
+        static atomic<const char*> formats[MAX_FORMATS];
+        return formats;
+    }
+
+    public:
+/**
+ * @return The format registered under the id. The id must come from registerFormat().
+ */
+    static const char *format(uint16_t formatId){
+        return table()[formatId].load(memory_order_acquire);
+    }
+
+    static uint16_t registerFormat(const char *format){
+        static mutex registryMutex;
+        static size_t count = 0;
+        lock_guard<mutex> lock(registryMutex);
+        if(count == MAX_FORMATS){
+            throw length_error("FormatRegistry: more than 65536 log formats");
+        }
+        table()[count].store(format, memory_order_release);
+        return (uint16_t)count++;
+    }
+};
+
+/**
+ * The BinaryLogSink writes records into memory-mapped segment files named <base>.0, <base>.1, ...
+ * When a segment is full the next one is started and the format strings used so far are written
+ * again, so every segment decodes on its own. A sink is meant to be used by one thread.
+ */
+class BinaryLogSink{
+    string basePath;
+    size_t segmentSize;
+    int segmentIndex;
+    int fd;
+    char *segment;            // Start of the mapping
+    size_t offset;            // Write position, relative to the mapping
+    vector<bool> announced;   // Format ids already written to the current segment
+    long long records;
+    long long bytes;
+
+    void openSegment(){
+        string path = basePath + "." + to_string(segmentIndex);
+        fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if(fd < 0 || ftruncate(fd, (off_t)segmentSize) != 0){
+            throw runtime_error("BinaryLogSink: cannot create " + path);
+        }
+        void *mapping = mmap(NULL, segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if(mapping == MAP_FAILED){
+            throw runtime_error("BinaryLogSink: cannot map " + path);
+        }
+        segment = static_cast<char*>(mapping);
+        SegmentHeader header = {{'B', 'L', 'O', 'G'}, 1, 0};
+        memcpy(segment, &header, sizeof(header));
+        offset = sizeof(SegmentHeader);
+        announced.assign(announced.size(), false);
+    }
+
+    void closeSegment(){
+        if(segment == NULL){
+            return;
+        }
+        munmap(segment, segmentSize);
+        // Shrink the file to what was actually written.
+        if(ftruncate(fd, (off_t)offset) != 0){
+            cerr<<"BinaryLogSink: cannot truncate segment "<<segmentIndex<<endl;
+        }
+        close(fd);
+        segment = NULL;
+    }
+
+    void publish(){
+        uint64_t used = offset - sizeof(SegmentHeader);
+        memcpy(segment + offsetof(SegmentHeader, used), &used, sizeof(used));
+    }
+
+    void nextSegment(){
+        closeSegment();
+        segmentIndex++;
+        openSegment();
+    }
+
+/**
+ * Take `size` bytes of the current segment. The caller has made sure they fit.
+ */
+    char *reserve(size_t size){
+        char *out = segment + offset;
+        offset += size;
+        bytes += size;
+        return out;
+    }
+
+/**
+ * @return The bytes the format record of `formatId` takes, or 0 if the current segment has it.
+ */
+    size_t announcementSize(uint16_t formatId){
+        if(formatId < announced.size() && announced[formatId]){
+            return 0;
+        }
+        return 1 + 2 + 4 + strlen(FormatRegistry::format(formatId));
+    }
+
+    void announce(uint16_t formatId){
+        if(formatId >= announced.size()){
+            announced.resize(formatId + 1, false);
+        }
+        if(announced[formatId]){
+            return;
+        }
+        const char *format = FormatRegistry::format(formatId);
+        uint32_t length = (uint32_t)strlen(format);
+        char *out = reserve(1 + 2 + 4 + length);
+        *out++ = RECORD_FORMAT;
+        memcpy(out, &formatId, 2);
+        memcpy(out + 2, &length, 4);
+        memcpy(out + 6, format, length);
+        announced[formatId] = true;
+    }
+
+    public:
+    BinaryLogSink(const string &path, size_t size = 64 << 20)
+        : basePath(path), segmentSize(size), segmentIndex(0), fd(-1), segment(NULL), offset(0), records(0), bytes(0){
+        openSegment();
+    }
+
+    ~BinaryLogSink(){
+        closeSegment();
+    }
+
+/**
+ * Append one log record:
+ * kind (1) | format id (2) | level (1) | timestamp ns (8) | argument count (1) | arguments.
+ * The record and, if the segment lacks it, its format record go into the same segment: when both
+ * do not fit, a new segment is started first and the format is announced there.
+ */
+    void append(int level, uint16_t formatId, uint8_t argCount, const LogArguments &args){
+        size_t size = 1 + 2 + 1 + 8 + 1 + args.size();
+        if(offset + announcementSize(formatId) + size > segmentSize){
+            nextSegment();
+            if(offset + announcementSize(formatId) + size > segmentSize){
+                throw length_error("BinaryLogSink: record larger than a segment");
+            }
+        }
+        announce(formatId);
+        char *out = reserve(size);
+        int64_t timestamp = chrono::duration_cast<chrono::nanoseconds>(chrono::system_clock::now().time_since_epoch()).count();
+        uint8_t lvl = (uint8_t)level;
+        *out++ = RECORD_LOG;
+        memcpy(out, &formatId, 2);
+        out[2] = (char)lvl;
+        memcpy(out + 3, &timestamp, 8);
+        out[11] = (char)argCount;
+        args.encodeAll(out + 12);
+        records++;
+        publish();
+    }
+
+    int getSegmentCount(){
+        return segmentIndex + 1;
+    }
+
+    double bytesPerRecord(){
+        return records == 0 ? 0 : (double)bytes / records;
+    }
+};
+
+/**
+ * The LogProcessor class is the base class for all log processors in the chain. Processors with a
+ * sink write binary records, the others print text to their stream as before.
+ */
+class LogProcessor{
+    protected:
+    LogProcessor *nextLogProcessor;
+    BinaryLogSink *sink;
+    ostream &out;
+
+    void emit(const int logLevel, const char *label, uint16_t formatId, uint8_t argCount, const LogArguments &args){
+        if(sink != NULL){
+            sink->append(logLevel, formatId, argCount, args);
+        }
+        else{
+            out<<label<<" ";
+            args.render(out, FormatRegistry::format(formatId));
+            out<<endl;
+        }
+    }
+
+    public:
+    static constexpr int INFO = 1;
+    static constexpr int DEBUG = 2;
+    static constexpr int ERROR = 3;
+
+    LogProcessor(LogProcessor *nlp, BinaryLogSink *s = NULL, ostream &os = cout): nextLogProcessor(nlp), sink(s), out(os){}
+
+    virtual ~LogProcessor(){
+        delete nextLogProcessor;
+    }
+
+/**
+ * Pass the call to the next processor in the chain, if any.
+ */
+    virtual void log(const int logLevel, uint16_t formatId, uint8_t argCount, const LogArguments &args){
+        if(nextLogProcessor!=NULL){
+            nextLogProcessor->log(logLevel, formatId, argCount, args);
+        }
+    }
+};
+
+class InfoLogProcessor: public LogProcessor{
+    public:
+    InfoLogProcessor(LogProcessor *nlp, BinaryLogSink *s = NULL, ostream &os = cout): LogProcessor(nlp, s, os){}
+
+    void log(const int logLevel, uint16_t formatId, uint8_t argCount, const LogArguments &args){
+        if(logLevel == INFO){
+            emit(logLevel, "INFO", formatId, argCount, args);
+        }
+        else{
+            LogProcessor::log(logLevel, formatId, argCount, args);
+        }
+    }
+};
+
+/**
+ * The DebugLogProcessor class handles log messages with DEBUG level.
+ */
+class DebugLogProcessor: public LogProcessor{
+    public:
+    DebugLogProcessor(LogProcessor *nlp, BinaryLogSink *s = NULL, ostream &os = cout): LogProcessor(nlp, s, os){}
+
+    void log(const int logLevel, uint16_t formatId, uint8_t argCount, const LogArguments &args){
+        if(logLevel == DEBUG){
+            emit(logLevel, "DEBUG", formatId, argCount, args);
+        }
+        else{
+            LogProcessor::log(logLevel, formatId, argCount, args);
+        }
+    }
+};
+
+/**
+ * The ErrorLogProcessor class handles log messages with ERROR level.
+ */
+class ErrorLogProcessor: public LogProcessor{
+    public:
+    ErrorLogProcessor(LogProcessor *nlp, BinaryLogSink *s = NULL, ostream &os = cout): LogProcessor(nlp, s, os){}
+
+    void log(const int logLevel, uint16_t formatId, uint8_t argCount, const LogArguments &args){
+        if(logLevel == ERROR){
+            emit(logLevel, "ERROR", formatId, argCount, args);
+        }
+        else{
+            LogProcessor::log(logLevel, formatId, argCount, args);
+        }
+    }
+};
+
+template <typename... Args>
+void logWithFormat(LogProcessor *chain, int level, uint16_t formatId, const Args &...args){
+    static_assert(sizeof...(Args) < 256, "too many log arguments");
+    chain->log(level, formatId, (uint8_t)sizeof...(Args), TypedLogArguments<Args...>(args...));
+}
+
+// Logs through `chain`. The format string must be a literal: it is registered once per call site
+// and only its id is stored in binary records.
+#define BINARY_LOG(chain, level, format, ...)                                          \
+    do {                                                                               \
+        static const uint16_t formatId = FormatRegistry::registerFormat(format);       \
+        logWithFormat((chain), (level), formatId, ##__VA_ARGS__);                      \
+    } while (0)
+
+/**
+ * The offline decoder. Reads segment files and prints every log record as text.
+ * @return The number of log records decoded.
+ */
+long long decodeSegment(const string &path, ostream &out){
+    ifstream file(path, ios::binary);
+    if(!file){
+        throw runtime_error("decode: cannot open " + path);
+    }
+    vector<char> data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    SegmentHeader header;
+    if(data.size() < sizeof(header)){
+        throw runtime_error("decode: " + path + " is too short");
+    }
+    memcpy(&header, data.data(), sizeof(header));
+    if(memcmp(header.magic, "BLOG", 4) != 0 || header.version != 1){
+        throw runtime_error("decode: " + path + " is not a binary log segment");
+    }
+    const char *p = data.data() + sizeof(header);
+    const char *end = p + min<uint64_t>(header.used, data.size() - sizeof(header));
+    map<uint16_t, string> formats;
+    const char *levelNames[] = {"?", "INFO", "DEBUG", "ERROR"};
+    long long decoded = 0;
+
+    auto need = [&](size_t n){
+        if((size_t)(end - p) < n){
+            throw runtime_error("decode: truncated record in " + path);
+        }
+    };
+    while(p < end){
+        uint8_t kind = (uint8_t)*p++;
+        if(kind == RECORD_FORMAT){
+            uint16_t id;
+            uint32_t length;
+            need(6);
+            memcpy(&id, p, 2);
+            memcpy(&length, p + 2, 4);
+            p += 6;
+            need(length);
+            formats[id] = string(p, length);
+            p += length;
+            continue;
+        }
+        if(kind != RECORD_LOG){
+            throw runtime_error("decode: unknown record kind in " + path);
+        }
+        need(12);
+        uint16_t id;
+        int64_t timestamp;
+        memcpy(&id, p, 2);
+        uint8_t level = (uint8_t)p[2];
+        memcpy(&timestamp, p + 3, 8);
+        uint8_t argCount = (uint8_t)p[11];
+        p += 12;
+
+        auto known = formats.find(id);
+        if(known == formats.end()){
+            throw runtime_error("decode: record uses undefined format " + to_string(id) + " in " + path);
+        }
+        const string &format = known->second;
+        size_t rest = 0;
+        out<<timestamp<<" "<<(level < 4 ? levelNames[level] : "?")<<" ";
+        for(int i = 0; i < argCount; i++){
+            need(1);
+            uint8_t type = (uint8_t)*p++;
+            size_t placeholder = format.find("{}", rest);
+            if(placeholder != string::npos){
+                out.write(format.data() + rest, placeholder - rest);
+                rest = placeholder + 2;
+            }
+            if(type == ARG_INT){
+                int64_t v;
+                need(8);
+                memcpy(&v, p, 8);
+                p += 8;
+                out<<v;
+            }
+            else if(type == ARG_DOUBLE){
+                double v;
+                need(8);
+                memcpy(&v, p, 8);
+                p += 8;
+                out<<v;
+            }
+            else if(type == ARG_STRING){
+                uint32_t length;
+                need(4);
+                memcpy(&length, p, 4);
+                p += 4;
+                need(length);
+                out.write(p, length);
+                p += length;
+            }
+            else{
+                throw runtime_error("decode: unknown argument type in " + path);
+            }
+        }
+        out<<format.substr(min(rest, format.size()))<<"\n";
+        decoded++;
+    }
+    return decoded;
+}
+
+/**
+ * Compare ns per call and bytes per record of the text path (cout with endl, redirected to
+ * /dev/null) and the binary sink, using the same calls.
+ */
+void benchmark(const string &basePath, int iterations){
+    string endpoint = "/api/orders";
+
+    ofstream devNull("/dev/null");
+    LogProcessor *textChain = new InfoLogProcessor(new DebugLogProcessor(new ErrorLogProcessor(NULL, NULL, devNull), NULL, devNull), NULL, devNull);
+    ostringstream sample;
+    LogProcessor *sampleChain = new ErrorLogProcessor(NULL, NULL, sample);
+    BINARY_LOG(sampleChain, LogProcessor::ERROR, "request {} to {} failed after {} ms with status {}", 123456, endpoint, 12.5, 503);
+    delete sampleChain;
+
+    auto textStart = chrono::steady_clock::now();
+    for(int i = 0; i < iterations; i++){
+        BINARY_LOG(textChain, LogProcessor::ERROR, "request {} to {} failed after {} ms with status {}", i, endpoint, i * 0.5, 503);
+    }
+    auto textEnd = chrono::steady_clock::now();
+    delete textChain;
+
+    BinaryLogSink *sink = new BinaryLogSink(basePath);
+    LogProcessor *binaryChain = new InfoLogProcessor(new DebugLogProcessor(new ErrorLogProcessor(NULL, sink), sink), sink);
+    auto binaryStart = chrono::steady_clock::now();
+    for(int i = 0; i < iterations; i++){
+        BINARY_LOG(binaryChain, LogProcessor::ERROR, "request {} to {} failed after {} ms with status {}", i, endpoint, i * 0.5, 503);
+    }
+    auto binaryEnd = chrono::steady_clock::now();
+    double bytesPerRecord = sink->bytesPerRecord();
+    int segments = sink->getSegmentCount();
+    delete binaryChain;
+    delete sink;
+
+    ostringstream decodedText;
+    long long decoded = 0;
+    for(int s = 0; s < segments; s++){
+        decoded += decodeSegment(basePath + "." + to_string(s), decodedText);
+    }
+    for(int s = 0; s < segments; s++){
+        remove((basePath + "." + to_string(s)).c_str());
+    }
+
+    auto ns = [&](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b){
+        return chrono::duration<double, nano>(b - a).count() / iterations;
+    };
+    cout<<"text cout path: "<<ns(textStart, textEnd)<<" ns/call, "<<sample.str().size()<<" bytes/record"<<endl;
+    cout<<"binary sink:    "<<ns(binaryStart, binaryEnd)<<" ns/call, "<<bytesPerRecord<<" bytes/record, "
+        <<segments<<" segment(s), "<<decoded<<" records decoded"<<endl;
+}
+
+/**
+ * With `decode <files...>` prints the given segments as text. Otherwise logs a few messages to a
+ * segment and decodes it, checks that tiny segments decode after every rollover, and runs the
+ * benchmark.
+ */
+int main(int argc, char **argv) {
+    if(argc >= 2 && string(argv[1]) == "decode"){
+        int failed = 0;
+        for(int i = 2; i < argc; i++){
+            try{
+                decodeSegment(argv[i], cout);
+            }
+            catch(const exception &e){
+                cerr<<argv[i]<<": "<<e.what()<<endl;
+                failed++;
+            }
+        }
+        return failed == 0 ? 0 : 1;
+    }
+
+    string basePath = (filesystem::temp_directory_path() / "binary-log-demo").string();
+    {
+        BinaryLogSink sink(basePath);
+        LogProcessor *logProcessor = new InfoLogProcessor(new DebugLogProcessor(new ErrorLogProcessor(NULL, &sink), &sink), &sink);
+        BINARY_LOG(logProcessor, LogProcessor::ERROR, "get error");
+        BINARY_LOG(logProcessor, LogProcessor::INFO, "user {} logged in from {}", 42, "10.0.0.7");
+        BINARY_LOG(logProcessor, LogProcessor::DEBUG, "cache hit ratio {}", 0.93);
+        delete logProcessor;
+    }
+    decodeSegment(basePath + ".0", cout);
+    remove((basePath + ".0").c_str());
+
+    // Tiny segments roll over every few records; each one must still decode on its own.
+    int segments, logged = 200;
+    {
+        BinaryLogSink sink(basePath, 256);
+        LogProcessor *logProcessor = new InfoLogProcessor(new DebugLogProcessor(new ErrorLogProcessor(NULL, &sink), &sink), &sink);
+        for(int i = 0; i < logged; i++){
+            if(i % 2 == 0){
+                BINARY_LOG(logProcessor, LogProcessor::INFO, "user {} logged in from {}", i, "10.0.0.7");
+            }
+            else{
+                BINARY_LOG(logProcessor, LogProcessor::DEBUG, "cache hit ratio {}", i / 1000.0);
+            }
+        }
+        segments = sink.getSegmentCount();
+        delete logProcessor;
+    }
+    ostringstream rolledText;
+    long long rolledRecords = 0;
+    for(int s = 0; s < segments; s++){
+        rolledRecords += decodeSegment(basePath + "." + to_string(s), rolledText);
+        remove((basePath + "." + to_string(s)).c_str());
+    }
+    cout<<"256-byte segments: "<<logged<<" records in "<<segments<<" segments, "<<rolledRecords<<" decoded"<<endl;
+
+    cout<<"--------------"<<endl;
+    benchmark((filesystem::temp_directory_path() / "binary-log-bench").string(), 1000000);
+}
@@ -0,0 +1,314 @@
+
+// Chain of Responsibility with a Dispatch Table:
+// The classic chain walks every processor through a virtual call, copying the message string at
+// each hop and printing "going next" along the way. This variant keeps the same processors and
+// the same chain, but a LogDispatcher can compile the chain into a table indexed by log level.
+// A log call then goes straight to the processor that would have handled it, in O(1), and the
+// message is passed as a string_view so it is never copied.
+#include <bits/stdc++.h>
+using namespace std;
+
+/**
+ * The LogProcessor class is the base class for all log processors in the chain.
+ * A processor says which levels it handles through canHandle() and prints a message through
+ * write(). log() keeps the classic behaviour of walking the chain. A processor that overrides
+ * canHandle() also overrides declaresLevels(); one that only overrides log() is treated by the
+ * LogDispatcher as opaque and always reached through its log().
+ */
+class LogProcessor{
+    protected:
+    LogProcessor *nextLogProcessor;
+    ostream &out;
+
+    public:
+    const int INFO = 1;
+    const int DEBUG = 2;
+    const int ERROR = 3;
+    static const int MAX_LOG_LEVEL = 63;
+
+/**
+ * Constructor for LogProcessor.
+ *
+ * @param nlp A pointer to the next LogProcessor in the chain, or NULL for the last one.
+ * @param os  The stream messages are written to.
+ */
+    LogProcessor(LogProcessor *nlp, ostream &os = cout): nextLogProcessor(nlp), out(os){}
+
+    virtual ~LogProcessor() = default;
+
+/**
+ * @return true if canHandle() and write() describe this processor completely, so a dispatcher may
+ * call write() directly instead of log().
+ */
+    virtual bool declaresLevels(){
+        return false;
+    }
+
+/**
+ * @return true if this processor handles messages of the given level.
+ */
+    virtual bool canHandle(const int logLevel){
+        return false;
+    }
+
+/**
+ * Print a message this processor handles.
+ */
+    virtual void write(const int logLevel, string_view message){}
+
+/**
+ * Handle the message here if possible, otherwise pass it to the next processor in the chain.
+ * If the current processor is the last one in the chain, the message is dropped.
+ *
+ * @param logLevel The level of the log message.
+ * @param message The log message itself.
+ */
+    virtual void log(const int logLevel, string message){
+        if(canHandle(logLevel)){
+            write(logLevel, message);
+        }
+        else if(nextLogProcessor!=NULL){
+            out<<"going next"<<endl;
+            nextLogProcessor->log(logLevel, message);
+        }
+    }
+
+    LogProcessor *getNext(){
+        return nextLogProcessor;
+    }
+};
+
+class InfoLogProcessor: public LogProcessor{
+    public:
+    InfoLogProcessor(LogProcessor *nlp, ostream &os = cout): LogProcessor(nlp, os){}
+
+    bool declaresLevels(){
+        return true;
+    }
+
+    bool canHandle(const int logLevel){
+        return logLevel == INFO;
+    }
+
+    void write(const int logLevel, string_view message){
+        out<<"INFO "<<message<<endl;
+    }
+};
+
+/**
+ * The DebugLogProcessor class handles log messages with DEBUG level.
+ */
+class DebugLogProcessor: public LogProcessor{
+    public:
+    DebugLogProcessor(LogProcessor *nlp, ostream &os = cout): LogProcessor(nlp, os){}
+
+    bool declaresLevels(){
+        return true;
+    }
+
+    bool canHandle(const int logLevel){
+        return logLevel == DEBUG;
+    }
+
+    void write(const int logLevel, string_view message){
+        out<<"DEBUG "<<message<<endl;
+    }
+};
+
+/**
+ * The ErrorLogProcessor class handles log messages with ERROR level.
+ */
+class ErrorLogProcessor: public LogProcessor{
+    public:
+    ErrorLogProcessor(LogProcessor *nlp, ostream &os = cout): LogProcessor(nlp, os){}
+
+    bool declaresLevels(){
+        return true;
+    }
+
+    bool canHandle(const int logLevel){
+        return logLevel == ERROR;
+    }
+
+    void write(const int logLevel, string_view message){
+        out<<"ERROR "<<message<<endl;
+    }
+};
+
+/**
+ * A processor for an arbitrary single level, used to build long chains for the benchmark.
+ */
+class LevelLogProcessor: public LogProcessor{
+    int level;
+    string label;
+
+    public:
+    LevelLogProcessor(int lvl, string lbl, LogProcessor *nlp, ostream &os = cout): LogProcessor(nlp, os), level(lvl), label(lbl){}
+
+    bool declaresLevels(){
+        return true;
+    }
+
+    bool canHandle(const int logLevel){
+        return logLevel == level;
+    }
+
+    void write(const int logLevel, string_view message){
+        out<<label<<" "<<message<<endl;
+    }
+};
+
+/**
+ * The LogDispatcher compiles a chain into a table from log level to the processor that the chain
+ * would deliver that level to. The first processor in chain order wins, exactly as in the walk.
+ * The first opaque processor (see declaresLevels()) ends the compiled part: every level not
+ * claimed before it is routed to its log(), which continues the classic walk from there. Levels
+ * outside 0..MAX_LOG_LEVEL are walked from the head of the chain. The chain must not change after
+ * the dispatcher is built; build a new dispatcher if it does.
+ */
+class LogDispatcher{
+    struct Route{
+        LogProcessor *processor;
+        bool walk;              // Call processor->log() rather than write()
+    };
+
+    LogProcessor *chain;
+    array<Route, LogProcessor::MAX_LOG_LEVEL + 1> table;
+
+    public:
+    LogDispatcher(LogProcessor *head): chain(head){
+        table.fill({NULL, false});
+        for(LogProcessor *processor = chain; processor != NULL; processor = processor->getNext()){
+            bool opaque = !processor->declaresLevels();
+            for(int level = 0; level <= LogProcessor::MAX_LOG_LEVEL; level++){
+                if(table[level].processor == NULL && (opaque || processor->canHandle(level))){
+                    table[level] = {processor, opaque};
+                }
+            }
+            if(opaque){
+                break;
+            }
+        }
+    }
+
+/**
+ * Deliver a message to the processor for its level, or drop it if no processor handles it.
+ *
+ * @param logLevel The level of the log message.
+ * @param message The log message itself. It is only copied when the message is walked.
+ */
+    void log(const int logLevel, string_view message){
+        if(logLevel < 0 || logLevel > LogProcessor::MAX_LOG_LEVEL){
+            if(chain != NULL){
+                chain->log(logLevel, string(message));
+            }
+            return;
+        }
+        Route &route = table[logLevel];
+        if(route.processor == NULL){
+            return;
+        }
+        if(route.walk){
+            route.processor->log(logLevel, string(message));
+        }
+        else{
+            route.processor->write(logLevel, message);
+        }
+    }
+};
+
+/**
+ * A processor written before canHandle() existed: it only overrides log(), handling AUDIT and
+ * passing everything else on.
+ */
+class AuditLogProcessor: public LogProcessor{
+    public:
+    static const int AUDIT = 7;
+
+    AuditLogProcessor(LogProcessor *nlp, ostream &os = cout): LogProcessor(nlp, os){}
+
+    void log(const int logLevel, string message){
+        if(logLevel == AUDIT){
+            out<<"AUDIT "<<message<<endl;
+        }
+        else if(nextLogProcessor!=NULL){
+            nextLogProcessor->log(logLevel, message);
+        }
+    }
+};
+
+/**
+ * A stream buffer that discards everything, so the benchmark measures dispatch rather than I/O.
+ */
+class NullBuffer: public streambuf{
+    protected:
+    int overflow(int c){
+        return c;
+    }
+
+    streamsize xsputn(const char *s, streamsize n){
+        return n;
+    }
+};
+
+/**
+ * Measure per-call cost of logging the level handled by the last processor of a chain, through
+ * the classic walk and through the dispatch table.
+ */
+void benchmark(int chainLength, int iterations){
+    NullBuffer nullBuffer;
+    ostream nullStream(&nullBuffer);
+
+    LogProcessor *chain = NULL;
+    for(int level = chainLength; level >= 1; level--){
+        chain = new LevelLogProcessor(level, "LEVEL" + to_string(level), chain, nullStream);
+    }
+    LogDispatcher dispatcher(chain);
+    string message = "request failed: upstream connection reset by peer";
+
+    auto walkStart = chrono::steady_clock::now();
+    for(int i = 0; i < iterations; i++){
+        chain->log(chainLength, message);
+    }
+    auto walkEnd = chrono::steady_clock::now();
+    for(int i = 0; i < iterations; i++){
+        dispatcher.log(chainLength, message);
+    }
+    auto tableEnd = chrono::steady_clock::now();
+
+    double walkNs = chrono::duration<double, nano>(walkEnd - walkStart).count() / iterations;
+    double tableNs = chrono::duration<double, nano>(tableEnd - walkEnd).count() / iterations;
+    cout<<"chain length "<<chainLength<<": chain walk "<<walkNs<<" ns/call, dispatch table "<<tableNs<<" ns/call"<<endl;
+
+    while(chain != NULL){
+        LogProcessor *next = chain->getNext();
+        delete chain;
+        chain = next;
+    }
+}
+
+/**
+ * Build the classic INFO -> DEBUG -> ERROR chain, log an ERROR through the chain walk and through
+ * the dispatch table, route an opaque processor and an out-of-range level through the dispatcher,
+ * then benchmark both for chain lengths from 3 to 50.
+ */
+int main() {
+
+    LogProcessor *logProcessor = new InfoLogProcessor(new DebugLogProcessor(new ErrorLogProcessor(NULL)));
+    logProcessor->log(logProcessor->ERROR, "get error");
+
+    LogDispatcher dispatcher(logProcessor);
+    dispatcher.log(logProcessor->ERROR, "get error");
+
+    cout<<"--------------"<<endl;
+    LogProcessor *mixed = new InfoLogProcessor(new AuditLogProcessor(new LevelLogProcessor(100, "LEVEL100", NULL)));
+    LogDispatcher mixedDispatcher(mixed);
+    mixedDispatcher.log(mixed->INFO, "get info");
+    mixedDispatcher.log(AuditLogProcessor::AUDIT, "get audit");
+    mixedDispatcher.log(100, "get level 100");
+
+    cout<<"--------------"<<endl;
+    for(int chainLength : {3, 10, 25, 50}){
+        benchmark(chainLength, 200000);
+    }
+}
@@ -0,0 +1,297 @@
+
+// Chain of Responsibility with Level Filtering and Lazy Formatting:
+// With log(const int logLevel, string message) the caller always builds the whole message, even
+// when no processor is going to print it. This variant adds logging macros that filter in two
+// steps. Levels left out of LOG_COMPILED_LEVELS are removed at compile time, including the
+// evaluation of their arguments. Levels that are compiled in check the chain's runtime level mask
+// before anything else. When a call gets past both checks, the format string and references to
+// the arguments travel down the chain as a record, and the text is only produced by the
+// processor that accepts it.
+#include <bits/stdc++.h>
+using namespace std;
+
+/**
+ * A log message that is rendered on demand.
+ */
+class LogRecord{
+    public:
+    virtual void render(ostream &out) const = 0;
+};
+
+/**
+ * A ready-made message, used by the classic string API.
+ */
+class StringLogRecord: public LogRecord{
+    const string &message;
+
+    public:
+    StringLogRecord(const string &msg): message(msg){}
+
+    void render(ostream &out) const{
+        out<<message;
+    }
+};
+
+/**
+ * A format string with "{}" placeholders plus references to its arguments. The arguments are only
+ * streamed when render() is called. The record must not outlive the log call that created it.
+ */
+template <typename... Args>
+class LazyLogRecord: public LogRecord{
+    const char *format;
+    tuple<const Args &...> args;
+
+    template <size_t... I>
+    void renderArgs(ostream &out, index_sequence<I...>) const{
+        const char *rest = format;
+        auto renderOne = [&](const auto &arg){
+            const char *placeholder = strstr(rest, "{}");
+            if(placeholder == NULL){
+                return; // More arguments than placeholders: ignore the extras
+            }
+            out.write(rest, placeholder - rest);
+            out<<arg;
+            rest = placeholder + 2;
+        };
+        (void)renderOne; // Unused when there are no arguments
+        (renderOne(get<I>(args)), ...);
+        out<<rest;
+    }
+
+    public:
+    LazyLogRecord(const char *fmt, const Args &...a): format(fmt), args(a...){}
+
+    void render(ostream &out) const{
+        renderArgs(out, index_sequence_for<Args...>());
+    }
+};
+
+template <typename... Args>
+LazyLogRecord<Args...> makeLogRecord(const char *format, const Args &...args){
+    return LazyLogRecord<Args...>(format, args...);
+}
+
+/**
+ * The LogProcessor class is the base class for all log processors in the chain. The head of the
+ * chain also carries the runtime level mask checked by the logging macros.
+ */
+class LogProcessor{
+    protected:
+    LogProcessor *nextLogProcessor;
+    uint64_t enabledLevels;
+
+    public:
+    static constexpr int INFO = 1;
+    static constexpr int DEBUG = 2;
+    static constexpr int ERROR = 3;
+    static constexpr int TRACE = 4;
+    static constexpr int MAX_LOG_LEVEL = 63;  // Levels are bits of a 64-bit mask: 0..63
+
+    LogProcessor(LogProcessor *nlp): nextLogProcessor(nlp), enabledLevels(~0ull){}
+
+    virtual ~LogProcessor(){
+        delete nextLogProcessor;
+    }
+
+/**
+ * Set which levels the logging macros let through at runtime, as a mask of (1ull << level) bits
+ * for levels 0..MAX_LOG_LEVEL.
+ */
+    void setEnabledLevels(uint64_t mask){
+        enabledLevels = mask;
+    }
+
+/**
+ * @return true if the level is enabled at runtime. Levels outside 0..MAX_LOG_LEVEL never are.
+ */
+    bool isEnabled(const int logLevel){
+        if(logLevel < 0 || logLevel > MAX_LOG_LEVEL){
+            return false;
+        }
+        return (enabledLevels >> logLevel) & 1u;
+    }
+
+/**
+ * Pass a record to the next processor in the chain, if any. If this is the last processor, the
+ * record is dropped without ever being rendered.
+ */
+    virtual void log(const int logLevel, const LogRecord &record){
+        if(nextLogProcessor!=NULL){
+            nextLogProcessor->log(logLevel, record);
+        }
+    }
+
+/**
+ * The classic entry point, kept for callers that already have the message text.
+ */
+    void log(const int logLevel, const string &message){
+        log(logLevel, StringLogRecord(message));
+    }
+};
+
+class InfoLogProcessor: public LogProcessor{
+    public:
+    InfoLogProcessor(LogProcessor *nlp): LogProcessor(nlp){}
+    using LogProcessor::log;
+
+    void log(const int logLevel, const LogRecord &record){
+        if(logLevel == INFO){
+            cout<<"INFO ";
+            record.render(cout);
+            cout<<endl;
+        }
+        else{
+            LogProcessor::log(logLevel, record);
+        }
+    }
+};
+
+/**
+ * The DebugLogProcessor class handles log messages with DEBUG level.
+ */
+class DebugLogProcessor: public LogProcessor{
+    public:
+    DebugLogProcessor(LogProcessor *nlp): LogProcessor(nlp){}
+    using LogProcessor::log;
+
+    void log(const int logLevel, const LogRecord &record){
+        if(logLevel == DEBUG){
+            cout<<"DEBUG ";
+            record.render(cout);
+            cout<<endl;
+        }
+        else{
+            LogProcessor::log(logLevel, record);
+        }
+    }
+};
+
+/**
+ * The ErrorLogProcessor class handles log messages with ERROR level.
+ */
+class ErrorLogProcessor: public LogProcessor{
+    public:
+    ErrorLogProcessor(LogProcessor *nlp): LogProcessor(nlp){}
+    using LogProcessor::log;
+
+    void log(const int logLevel, const LogRecord &record){
+        if(logLevel == ERROR){
+            cout<<"ERROR ";
+            record.render(cout);
+            cout<<endl;
+        }
+        else{
+            LogProcessor::log(logLevel, record);
+        }
+    }
+};
+
+/**
+ * The TraceLogProcessor class handles log messages with TRACE level. TRACE is not compiled in by
+ * default, so unless LOG_COMPILED_LEVELS includes it this processor never sees a message.
+ */
+class TraceLogProcessor: public LogProcessor{
+    public:
+    TraceLogProcessor(LogProcessor *nlp): LogProcessor(nlp){}
+    using LogProcessor::log;
+
+    void log(const int logLevel, const LogRecord &record){
+        if(logLevel == TRACE){
+            cout<<"TRACE ";
+            record.render(cout);
+            cout<<endl;
+        }
+        else{
+            LogProcessor::log(logLevel, record);
+        }
+    }
+};
+
+// Levels compiled into the binary, as a 64-bit mask of (1ull << level) bits. Override with
+// -DLOG_COMPILED_LEVELS=... at build time; by default everything except TRACE is compiled in.
+#ifndef LOG_COMPILED_LEVELS
+#define LOG_COMPILED_LEVELS ((1ull << LogProcessor::INFO) | (1ull << LogProcessor::DEBUG) | (1ull << LogProcessor::ERROR))
+#endif
+
+// Logs through `chain` at `level`. The first argument after the level is a format string with
+// "{}" placeholders. Arguments are not evaluated for compiled-out levels or for levels disabled at
+// runtime, and they are only formatted by the processor that accepts the record. The level must be
+// a constant in 0..LogProcessor::MAX_LOG_LEVEL.
+#define LOG_AT(chain, level, ...)                                           \
+    do {                                                                    \
+        static_assert((level) >= 0 && (level) <= LogProcessor::MAX_LOG_LEVEL,  \
+                      "log level out of range");                            \
+        if constexpr ((uint64_t(LOG_COMPILED_LEVELS) >> (level)) & 1u) {    \
+            if ((chain)->isEnabled(level)) {                                \
+                (chain)->log((level), makeLogRecord(__VA_ARGS__));          \
+            }                                                               \
+        }                                                                   \
+    } while (0)
+
+#define LOG_INFO(chain, ...) LOG_AT(chain, LogProcessor::INFO, __VA_ARGS__)
+#define LOG_DEBUG(chain, ...) LOG_AT(chain, LogProcessor::DEBUG, __VA_ARGS__)
+#define LOG_ERROR(chain, ...) LOG_AT(chain, LogProcessor::ERROR, __VA_ARGS__)
+#define LOG_TRACE(chain, ...) LOG_AT(chain, LogProcessor::TRACE, __VA_ARGS__)
+
+/**
+ * Measure the cost of a DEBUG call that ends up not being printed:
+ *  - before: the classic API builds the message and walks a chain without a DEBUG processor
+ *  - runtime filtered: LOG_DEBUG with DEBUG switched off in the runtime mask
+ *  - compiled out: LOG_TRACE, which is not in LOG_COMPILED_LEVELS
+ */
+void benchmark(int iterations){
+    LogProcessor *chain = new InfoLogProcessor(new ErrorLogProcessor(NULL));
+    string key = "session:7f3a9c";
+    volatile int sink = 0;
+
+    auto beforeStart = chrono::steady_clock::now();
+    for(int i = 0; i < iterations; i++){
+        chain->log(LogProcessor::DEBUG, "cache miss for " + key + " after " + to_string(i) + " lookups");
+        sink = i;
+    }
+    auto beforeEnd = chrono::steady_clock::now();
+
+    chain->setEnabledLevels(~(1ull << LogProcessor::DEBUG));
+    auto runtimeStart = chrono::steady_clock::now();
+    for(int i = 0; i < iterations; i++){
+        LOG_DEBUG(chain, "cache miss for {} after {} lookups", key, i);
+        sink = i;
+    }
+    auto runtimeEnd = chrono::steady_clock::now();
+
+    auto compiledStart = chrono::steady_clock::now();
+    for(int i = 0; i < iterations; i++){
+        LOG_TRACE(chain, "cache miss for {} after {} lookups", key, i);
+        sink = i;
+    }
+    auto compiledEnd = chrono::steady_clock::now();
+    (void)sink;
+
+    auto ns = [&](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b){
+        return chrono::duration<double, nano>(b - a).count() / iterations;
+    };
+    cout<<"suppressed DEBUG call: before "<<ns(beforeStart, beforeEnd)<<" ns, runtime filtered "
+        <<ns(runtimeStart, runtimeEnd)<<" ns, compiled out "<<ns(compiledStart, compiledEnd)<<" ns"<<endl;
+    delete chain;
+}
+
+/**
+ * Log through the classic API and the macros, switch DEBUG off at runtime, then run the benchmark.
+ */
+int main() {
+
+    LogProcessor *logProcessor = new InfoLogProcessor(new DebugLogProcessor(new ErrorLogProcessor(new TraceLogProcessor(NULL))));
+    logProcessor->log(logProcessor->ERROR, "get error");
+
+    int code = 503;
+    LOG_ERROR(logProcessor, "upstream returned {} for {}", code, "/api/orders");
+    LOG_DEBUG(logProcessor, "retrying in {} ms", 250);
+    LOG_TRACE(logProcessor, "not compiled in, never printed");
+
+    logProcessor->setEnabledLevels(~(1ull << LogProcessor::DEBUG));
+    LOG_DEBUG(logProcessor, "disabled at runtime, never printed");
+
+    cout<<"--------------"<<endl;
+    benchmark(5000000);
+    delete logProcessor;
+}
@@ -0,0 +1,542 @@
+
+// Chain of Responsibility with Multi-Sink Routing:
+// In the classic chain the processors are linked once in main() and every message stops at the
+// first processor that handles it. Here each processor writes to any number of sinks (a file, an
+// in-memory ring buffer, stderr), and every processor that accepts a level receives the message,
+// so one level can fan out to several sinks. A chain is compiled into an immutable RoutingTable
+// and published through an atomic pointer. Logging threads never take a lock: they announce
+// themselves to a small epoch-based reclamation scheme, read the current table and deliver the
+// message. A new chain can be published at any time, and a replaced table is only deleted once no
+// logging thread can still be reading it.
+#include <bits/stdc++.h>
+#include <fcntl.h>
+#include <unistd.h>
+using namespace std;
+
+/**
+ * A destination for formatted log lines. Sinks may be called from many threads at once.
+ */
+class LogSink{
+    public:
+    virtual void write(string_view line) = 0;
+    virtual ~LogSink() = default;
+};
+
+/**
+ * Writes each line with a single write() call on a file descriptor. Lines from different threads
+ * never interleave because each one is a single call on an O_APPEND file or a pipe.
+ */
+class FdSink: public LogSink{
+    int fd;
+    bool owned;
+
+    public:
+    FdSink(int descriptor, bool own = false): fd(descriptor), owned(own){}
+
+    static FdSink *openFile(const string &path){
+        return new FdSink(open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_TRUNC, 0644), true);
+    }
+
+    void write(string_view line){
+        char buffer[512];
+        size_t length = min(line.size(), sizeof(buffer) - 1);
+        memcpy(buffer, line.data(), length);
+        buffer[length] = '\n';
+        if(::write(fd, buffer, length + 1) < 0){
+            // A logging sink has nowhere to report its own failure; drop the line.
+        }
+    }
+
+    ~FdSink(){
+        if(owned){
+            close(fd);
+        }
+    }
+};
+
+/**
+ * Keeps the most recent lines in memory. Writers claim a position with an atomic counter and take
+ * the slot's busy flag without waiting: if another writer still holds the slot (the ring has
+ * wrapped around onto it), the line is dropped and counted instead of blocking the caller.
+ */
+class RingBufferSink: public LogSink{
+    static const size_t SLOT_TEXT = 120;
+
+    struct Slot{
+        atomic<bool> busy;
+        uint64_t ticket;
+        uint32_t length;
+        char text[SLOT_TEXT];
+    };
+
+    vector<Slot> slots;
+    atomic<uint64_t> next;
+    atomic<long long> dropped;
+
+    public:
+    RingBufferSink(size_t capacity): slots(capacity), next(0), dropped(0){
+        for(auto &slot : slots){
+            slot.busy.store(false);
+            slot.ticket = UINT64_MAX;
+        }
+    }
+
+    void write(string_view line){
+        uint64_t ticket = next.fetch_add(1, memory_order_relaxed);
+        Slot &slot = slots[ticket % slots.size()];
+        if(slot.busy.exchange(true, memory_order_acquire)){
+            dropped.fetch_add(1, memory_order_relaxed);
+            return;
+        }
+        slot.ticket = ticket;
+        slot.length = (uint32_t)min(line.size(), SLOT_TEXT);
+        memcpy(slot.text, line.data(), slot.length);
+        slot.busy.store(false, memory_order_release);
+    }
+
+    long long getDropped(){
+        return dropped.load();
+    }
+
+/**
+ * @return The most recent line, or an empty string if it is being overwritten right now.
+ */
+    string latest(){
+        uint64_t count = next.load(memory_order_acquire);
+        if(count == 0){
+            return "";
+        }
+        Slot &slot = slots[(count - 1) % slots.size()];
+        if(slot.busy.exchange(true, memory_order_acquire)){
+            return "";
+        }
+        string line = slot.ticket == count - 1 ? string(slot.text, slot.length) : "";
+        slot.busy.store(false, memory_order_release);
+        return line;
+    }
+};
+
+/**
+ * The LogProcessor class is the base class for all log processors in the chain. Each processor
+ * accepts some levels and writes accepted messages to all of its sinks.
+ */
+class LogProcessor{
+    protected:
+    LogProcessor *nextLogProcessor;
+    vector<LogSink*> sinks;
+
+    void writeToSinks(const char *label, string_view message){
+        char line[256];
+        int prefix = snprintf(line, sizeof(line), "%s ", label);
+        size_t length = min(message.size(), sizeof(line) - (size_t)prefix);
+        memcpy(line + prefix, message.data(), length);
+        for(auto sink : sinks){
+            sink->write(string_view(line, prefix + length));
+        }
+    }
+
+    public:
+    static constexpr int INFO = 1;
+    static constexpr int DEBUG = 2;
+    static constexpr int ERROR = 3;
+    static constexpr int MAX_LOG_LEVEL = 3;
+
+    LogProcessor(LogProcessor *nlp, vector<LogSink*> s): nextLogProcessor(nlp), sinks(s){}
+
+    virtual ~LogProcessor(){
+        delete nextLogProcessor;
+    }
+
+    virtual bool canHandle(const int logLevel) = 0;
+    virtual void write(const int logLevel, string_view message) = 0;
+
+    LogProcessor *getNext(){
+        return nextLogProcessor;
+    }
+};
+
+class InfoLogProcessor: public LogProcessor{
+    public:
+    InfoLogProcessor(LogProcessor *nlp, vector<LogSink*> s): LogProcessor(nlp, s){}
+
+    bool canHandle(const int logLevel){
+        return logLevel == INFO;
+    }
+
+    void write(const int logLevel, string_view message){
+        writeToSinks("INFO", message);
+    }
+};
+
+/**
+ * The DebugLogProcessor class handles log messages with DEBUG level.
+ */
+class DebugLogProcessor: public LogProcessor{
+    public:
+    DebugLogProcessor(LogProcessor *nlp, vector<LogSink*> s): LogProcessor(nlp, s){}
+
+    bool canHandle(const int logLevel){
+        return logLevel == DEBUG;
+    }
+
+    void write(const int logLevel, string_view message){
+        writeToSinks("DEBUG", message);
+    }
+};
+
+/**
+ * The ErrorLogProcessor class handles log messages with ERROR level.
+ */
+class ErrorLogProcessor: public LogProcessor{
+    public:
+    ErrorLogProcessor(LogProcessor *nlp, vector<LogSink*> s): LogProcessor(nlp, s){}
+
+    bool canHandle(const int logLevel){
+        return logLevel == ERROR;
+    }
+
+    void write(const int logLevel, string_view message){
+        writeToSinks("ERROR", message);
+    }
+};
+
+/**
+ * An immutable routing configuration compiled from a chain. For every level it lists all
+ * processors that accept it, in chain order. The table owns the chain.
+ */
+class RoutingTable{
+    LogProcessor *chain;
+    array<vector<LogProcessor*>, LogProcessor::MAX_LOG_LEVEL + 1> routes;
+
+    public:
+    RoutingTable(LogProcessor *head): chain(head){
+        for(LogProcessor *processor = head; processor != NULL; processor = processor->getNext()){
+            for(int level = 0; level <= LogProcessor::MAX_LOG_LEVEL; level++){
+                if(processor->canHandle(level)){
+                    routes[level].push_back(processor);
+                }
+            }
+        }
+    }
+
+    ~RoutingTable(){
+        delete chain;
+    }
+
+    void route(const int logLevel, string_view message) const{
+        if(logLevel < 0 || logLevel > LogProcessor::MAX_LOG_LEVEL){
+            return;
+        }
+        for(auto processor : routes[logLevel]){
+            processor->write(logLevel, message);
+        }
+    }
+};
+
+/**
+ * Epoch-based reclamation for routing tables. A logging thread announces the global epoch in its
+ * own slot while it reads the table and clears the slot afterwards. A table replaced at epoch E
+ * can be deleted once every slot is either idle or announces an epoch after E, because a thread
+ * that announced a later epoch read the pointer after the replacement.
+ */
+class EpochReclaimer{
+    static const int MAX_THREADS = 256;
+
+    public:
+    struct alignas(64) ReaderSlot{
+        atomic<uint64_t> epoch;   // 0 when the thread is not reading
+        atomic<bool> claimed;
+    };
+
+    private:
+    struct SlotTable{
+        ReaderSlot slots[MAX_THREADS];
+    };
+
+/**
+ * The slots one thread holds, one per reclaimer it has logged through. Entries are keyed by the
+ * reclaimer's unique id, never by its address, and hold the slot table weakly: a slot goes back to
+ * its table when the thread exits, and an entry whose reclaimer is gone is simply dropped.
+ */
+    struct ThreadSlots{
+        struct Entry{
+            uint64_t reclaimerId;
+            weak_ptr<SlotTable> table;
+            ReaderSlot *slot;
+        };
+        vector<Entry> entries;
+        size_t last = 0;  // Entry used most recently, checked first
+
+        ~ThreadSlots(){
+            for(auto &entry : entries){
+                if(auto table = entry.table.lock()){
+                    entry.slot->epoch.store(0);
+                    entry.slot->claimed.store(false, memory_order_release);
+                }
+            }
+        }
+
+        void dropExpired(){
+            entries.erase(remove_if(entries.begin(), entries.end(), [](const Entry &entry){
+                return entry.table.expired();
+            }), entries.end());
+            last = 0;
+        }
+    };
+
+    static atomic<uint64_t> nextId;
+
+    uint64_t id;
+    shared_ptr<SlotTable> table;  // Shared only so exiting threads can hand their slots back
+    atomic<uint64_t> globalEpoch;
+
+    ReaderSlot &claimSlot(){
+        for(auto &slot : table->slots){
+            bool expected = false;
+            if(slot.claimed.compare_exchange_strong(expected, true)){
+                return slot;
+            }
+        }
+        throw runtime_error("EpochReclaimer: too many logging threads");
+    }
+
+    public:
+    EpochReclaimer(): id(nextId++), table(make_shared<SlotTable>()), globalEpoch(1){
+        for(auto &slot : table->slots){
+            slot.epoch.store(0);
+            slot.claimed.store(false);
+        }
+    }
+
+/**
+ * @return The calling thread's slot in this reclaimer, claimed on first use. A thread holds one
+ * slot per reclaimer it logs through and gives them all back when it exits, so the limit is on
+ * threads logging through one reclaimer at the same time, not on how often they switch loggers.
+ */
+    ReaderSlot &slotForThisThread(){
+        thread_local ThreadSlots mine;
+        if(mine.last < mine.entries.size() && mine.entries[mine.last].reclaimerId == id){
+            return *mine.entries[mine.last].slot;
+        }
+        for(size_t i = 0; i < mine.entries.size(); i++){
+            if(mine.entries[i].reclaimerId == id){
+                mine.last = i;
+                return *mine.entries[i].slot;
+            }
+        }
+        mine.dropExpired();
+        ReaderSlot &slot = claimSlot();
+        mine.entries.push_back({id, table, &slot});
+        mine.last = mine.entries.size() - 1;
+        return slot;
+    }
+
+    void enter(ReaderSlot &slot){
+        slot.epoch.store(globalEpoch.load());
+    }
+
+    void exit(ReaderSlot &slot){
+        slot.epoch.store(0, memory_order_release);
+    }
+
+/**
+ * Start a new epoch after a replacement. @return The epoch the replaced object was retired in.
+ */
+    uint64_t advance(){
+        return globalEpoch.fetch_add(1);
+    }
+
+    bool isSafeToFree(uint64_t retiredEpoch){
+        for(auto &slot : table->slots){
+            uint64_t epoch = slot.epoch.load();
+            if(epoch != 0 && epoch <= retiredEpoch){
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+atomic<uint64_t> EpochReclaimer::nextId(1);
+
+/**
+ * The RoutingLogger is what application threads log through. log() is lock-free. publish() may be
+ * called from any thread; publishers are serialized among themselves, never with loggers.
+ */
+class RoutingLogger{
+    atomic<const RoutingTable*> current;
+    EpochReclaimer reclaimer;
+
+    mutex publishMutex;  // Only taken by publish()
+    vector<pair<const RoutingTable*, uint64_t>> retired;
+    long long reclaimed;
+
+    void collect(){
+        auto it = retired.begin();
+        while(it != retired.end()){
+            if(reclaimer.isSafeToFree(it->second)){
+                delete it->first;
+                reclaimed++;
+                it = retired.erase(it);
+            }
+            else{
+                ++it;
+            }
+        }
+    }
+
+    public:
+    RoutingLogger(LogProcessor *chain): current(new RoutingTable(chain)), reclaimed(0){}
+
+/**
+ * Must only run once no thread is logging any more.
+ */
+    ~RoutingLogger(){
+        delete current.load();
+        for(auto &entry : retired){
+            delete entry.first;
+        }
+    }
+
+    void log(const int logLevel, string_view message){
+        auto &slot = reclaimer.slotForThisThread();
+        reclaimer.enter(slot);
+        current.load()->route(logLevel, message);
+        reclaimer.exit(slot);
+    }
+
+/**
+ * Replace the routing with one compiled from a new chain. The old table is deleted as soon as no
+ * logging thread can be using it, possibly during a later publish() or collectNow().
+ */
+    void publish(LogProcessor *chain){
+        const RoutingTable *table = new RoutingTable(chain);
+        lock_guard<mutex> lock(publishMutex);
+        const RoutingTable *old = current.exchange(table);
+        retired.push_back({old, reclaimer.advance()});
+        collect();
+    }
+
+    void collectNow(){
+        lock_guard<mutex> lock(publishMutex);
+        collect();
+    }
+
+    long long getReclaimed(){
+        lock_guard<mutex> lock(publishMutex);
+        return reclaimed;
+    }
+
+    size_t getPending(){
+        lock_guard<mutex> lock(publishMutex);
+        return retired.size();
+    }
+};
+
+/**
+ * A sink that only counts, so the benchmark measures routing rather than I/O.
+ */
+class NullSink: public LogSink{
+    public:
+    void write(string_view line){}
+};
+
+/**
+ * Log from several threads while the main thread keeps publishing new chains, and compare the
+ * per-call cost with and without concurrent reconfiguration.
+ */
+void benchmark(int threads, int messagesPerThread){
+    NullSink nullSink;
+    RingBufferSink ring(4096);
+    auto chainA = [&]() -> LogProcessor* {
+        return new InfoLogProcessor(new ErrorLogProcessor(NULL, {&nullSink, &ring}), {&nullSink});
+    };
+    auto chainB = [&]() -> LogProcessor* {
+        return new ErrorLogProcessor(new InfoLogProcessor(new ErrorLogProcessor(NULL, {&ring}), {&nullSink, &ring}), {&nullSink});
+    };
+
+    for(bool swapping : {false, true}){
+        RoutingLogger logger(chainA());
+        atomic<bool> done(false);
+        atomic<long long> publishes(0);
+        thread publisher;
+        if(swapping){
+            publisher = thread([&](){
+                bool flip = false;
+                while(!done.load()){
+                    logger.publish(flip ? chainA() : chainB());
+                    flip = !flip;
+                    publishes++;
+                    this_thread::sleep_for(chrono::microseconds(100));
+                }
+            });
+        }
+        auto start = chrono::steady_clock::now();
+        vector<thread> workers;
+        for(int t = 0; t < threads; t++){
+            workers.emplace_back([&, t](){
+                string message = "worker " + to_string(t) + " processed batch";
+                for(int i = 0; i < messagesPerThread; i++){
+                    logger.log(i % 4 == 0 ? LogProcessor::ERROR : LogProcessor::INFO, message);
+                }
+            });
+        }
+        for(auto &worker : workers){
+            worker.join();
+        }
+        auto end = chrono::steady_clock::now();
+        done.store(true);
+        if(publisher.joinable()){
+            publisher.join();
+        }
+        logger.collectNow();
+
+        double ns = chrono::duration<double, nano>(end - start).count() / messagesPerThread;
+        cout<<(swapping ? "with swaps:   " : "static config: ")<<ns<<" ns/call per thread ("<<threads<<" threads)";
+        if(swapping){
+            cout<<", "<<publishes.load()<<" configs published, "<<logger.getReclaimed()<<" reclaimed, "
+                <<logger.getPending()<<" pending";
+        }
+        cout<<endl;
+    }
+}
+
+/**
+ * Route ERROR to stdout and a ring buffer and DEBUG to stderr, then swap in a chain that also sends
+ * ERROR and INFO to a file, and finally run the concurrent benchmark.
+ */
+int main() {
+    FdSink stderrSink(STDERR_FILENO);
+    FdSink stdoutSink(STDOUT_FILENO);
+    RingBufferSink ring(1024);
+    string filePath = (filesystem::temp_directory_path() / "multi-sink-demo.log").string();
+    FdSink *fileSink = FdSink::openFile(filePath);
+
+    RoutingLogger logger(new InfoLogProcessor(new DebugLogProcessor(new ErrorLogProcessor(NULL, {&stdoutSink, &ring}), {&stderrSink}), {&stdoutSink}));
+    logger.log(LogProcessor::ERROR, "get error");
+    cout<<"ring buffer holds: "<<ring.latest()<<endl;
+
+    // A second ERROR processor adds a file sink for the same level.
+    logger.publish(new InfoLogProcessor(new ErrorLogProcessor(new ErrorLogProcessor(NULL, {fileSink}), {&stdoutSink, &ring}), {&stdoutSink, fileSink}));
+    logger.log(LogProcessor::ERROR, "get error after reconfiguration");
+    logger.log(LogProcessor::INFO, "get info");
+    ifstream file(filePath);
+    cout<<"file holds:"<<endl<<file.rdbuf();
+    delete fileSink;
+    remove(filePath.c_str());
+
+    // Slots are per (thread, logger): switching between loggers, or through many short-lived
+    // ones, neither runs out of slots nor reuses the slot of a logger that was destroyed.
+    NullSink nullSink;
+    RoutingLogger first(new InfoLogProcessor(NULL, {&nullSink}));
+    RoutingLogger second(new InfoLogProcessor(NULL, {&nullSink}));
+    for(int i = 0; i < 1000; i++){
+        (i % 2 ? first : second).log(LogProcessor::INFO, "switch");
+        RoutingLogger shortLived(new InfoLogProcessor(NULL, {&nullSink}));
+        shortLived.log(LogProcessor::INFO, "short-lived");
+    }
+    cout<<"1000 logger switches and 1000 short-lived loggers on one thread: ok"<<endl;
+
+    cout<<"--------------"<<endl;
+    benchmark(4, 500000);
+}
@@ -0,0 +1,451 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Interpreter Design Pattern with an Expression Optimizer:
+// The plain interpreter evaluates an expression tree exactly as it was written, so a formula
+// like (num1*num2) + (num1*num2)*num3 computes num1*num2 twice. This variant adds an
+// optimization pass that hash-conses the tree into a DAG (identical subtrees become one node),
+// folds constant subtrees, applies simple algebraic identities (x+0, x*1, x*0) and then
+// evaluates every shared node exactly once per interpretation.
+
+// Context class
+// The Context class is used to store and retrieve variable values in the form of key-value pairs.
+class Context {
+private:
+    map<string, int> m; // Stores variable-value pairs
+
+public:
+    Context() {
+        m.clear();
+    }
+
+    /**
+     * @brief Adds a variable and its value to the context.
+     *
+     * @param var The variable name as a string.
+     * @param val The value of the variable as an integer.
+     */
+    void put(string var, int val) {
+        m[var] = val;
+    }
+
+    /**
+     * @brief Retrieves the value of a variable from the context.
+     *
+     * @param var The variable name as a string.
+     * @return The value of the variable as an integer.
+     */
+    int get(string var) {
+        return m[var];
+    }
+};
+
+// AbstractExpression class
+// Interface for all expression types.
+class AbstractExpression {
+public:
+    /**
+     * @brief Evaluates the expression using the provided context.
+     *
+     * @param context A pointer to the Context object containing variable values.
+     * @return The result of the interpretation as an integer.
+     */
+    virtual int interpreter(Context *context) = 0;
+    virtual ~AbstractExpression() = default;
+};
+
+// ConstantExpression class
+// Represents a literal number in the expression. Constants are what the optimizer folds.
+class ConstantExpression : public AbstractExpression {
+    int value; // The literal value
+
+public:
+    ConstantExpression(int val) : value(val) {}
+
+    int interpreter(Context *context) {
+        return value;
+    }
+
+    int getValue() {
+        return value;
+    }
+};
+
+// TerminalExpression class
+// Represents a variable in the expression, evaluated by looking it up in the context.
+class TerminalExpression : public AbstractExpression {
+    string variable; // The variable name
+
+public:
+    TerminalExpression(string var) : variable(var) {}
+
+    int interpreter(Context *context) {
+        return context->get(variable);
+    }
+
+    string getVariable() {
+        return variable;
+    }
+};
+
+// MultiplyNonTerminalExpression class
+// This class represents a multiplication operation between two expressions.
+class MultiplyNonTerminalExpression : public AbstractExpression {
+    AbstractExpression *leftExpresion;  // The left-hand operand
+    AbstractExpression *rightExpression; // The right-hand operand
+
+public:
+    MultiplyNonTerminalExpression(AbstractExpression *l, AbstractExpression *r)
+        : leftExpresion(l), rightExpression(r) {}
+
+    int interpreter(Context *context) {
+        return (leftExpresion->interpreter(context) * rightExpression->interpreter(context));
+    }
+
+    AbstractExpression *getLeft() {
+        return leftExpresion;
+    }
+
+    AbstractExpression *getRight() {
+        return rightExpression;
+    }
+};
+
+// SumNonTerminalExpression class
+// This class represents an addition operation between two expressions.
+class SumNonTerminalExpression : public AbstractExpression {
+    AbstractExpression *leftExpresion;  // The left-hand operand
+    AbstractExpression *rightExpression; // The right-hand operand
+
+public:
+    SumNonTerminalExpression(AbstractExpression *l, AbstractExpression *r)
+        : leftExpresion(l), rightExpression(r) {}
+
+    int interpreter(Context *context) {
+        return (leftExpresion->interpreter(context) + rightExpression->interpreter(context));
+    }
+
+    AbstractExpression *getLeft() {
+        return leftExpresion;
+    }
+
+    AbstractExpression *getRight() {
+        return rightExpression;
+    }
+};
+
+// OptimizedExpression class
+// An expression compiled into a DAG. Nodes are stored in a flat vector in creation order,
+// which is also a valid evaluation order because a node is only created after its operands.
+// Interpreting it walks the vector once, so every shared subexpression is computed a single time.
+class OptimizedExpression : public AbstractExpression {
+public:
+    enum Op { CONSTANT, VARIABLE, SUM, MULTIPLY };
+
+    // A single DAG node. Operands refer to earlier indices in the node vector.
+    struct Node {
+        Op op;
+        int value;   // Literal for CONSTANT, variable slot for VARIABLE
+        int left;    // Left operand index for SUM/MULTIPLY
+        int right;   // Right operand index for SUM/MULTIPLY
+    };
+
+private:
+    vector<Node> nodes;         // DAG nodes in evaluation order
+    vector<string> variables;   // Variable names, indexed by VARIABLE node value
+    int root;                   // Index of the result node
+    vector<int> values;         // Scratch space holding one value per node during evaluation
+
+    friend class ExpressionOptimizer;
+
+public:
+    OptimizedExpression() : root(-1) {}
+
+    /**
+     * @brief Evaluates the DAG, computing each shared node once.
+     *
+     * @param context A pointer to the Context object containing variable values.
+     * @return The result of the interpretation as an integer.
+     */
+    int interpreter(Context *context) {
+        values.resize(nodes.size());
+        for (size_t i = 0; i < nodes.size(); i++) {
+            const Node &node = nodes[i];
+            switch (node.op) {
+            case CONSTANT:
+                values[i] = node.value;
+                break;
+            case VARIABLE:
+                values[i] = context->get(variables[node.value]);
+                break;
+            case SUM:
+                values[i] = values[node.left] + values[node.right];
+                break;
+            case MULTIPLY:
+                values[i] = values[node.left] * values[node.right];
+                break;
+            }
+        }
+        return values[root];
+    }
+
+    // Number of distinct nodes left after optimization
+    int getNodeCount() {
+        return nodes.size();
+    }
+};
+
+// ExpressionOptimizer class
+// Converts an AbstractExpression tree into an OptimizedExpression. Every node is looked up in a
+// hash-cons table keyed by (op, value, left, right) before it is created, so structurally equal
+// subtrees map to the same node. Operands of the commutative SUM and MULTIPLY are put in a
+// canonical order, so a*b and b*a are shared too.
+class ExpressionOptimizer {
+    typedef tuple<int, int, int, int> NodeKey;
+
+    struct NodeKeyHash {
+        size_t operator()(const NodeKey &key) const {
+            size_t h = get<0>(key);
+            h = h * 1000003u ^ (size_t)get<1>(key);
+            h = h * 1000003u ^ (size_t)get<2>(key);
+            h = h * 1000003u ^ (size_t)get<3>(key);
+            return h;
+        }
+    };
+
+    OptimizedExpression *result;
+    unordered_map<NodeKey, int, NodeKeyHash> table;  // Hash-cons table
+    unordered_map<string, int> variableSlots;        // Variable name -> slot
+    unordered_map<AbstractExpression *, int> visited; // Tree nodes already converted (shared pointers)
+
+    int makeNode(OptimizedExpression::Op op, int value, int left, int right) {
+        NodeKey key(op, value, left, right);
+        auto it = table.find(key);
+        if (it != table.end()) {
+            return it->second;
+        }
+        int index = result->nodes.size();
+        result->nodes.push_back({op, value, left, right});
+        table[key] = index;
+        return index;
+    }
+
+    int makeConstant(int value) {
+        return makeNode(OptimizedExpression::CONSTANT, value, -1, -1);
+    }
+
+    bool isConstant(int index, int value) {
+        const OptimizedExpression::Node &node = result->nodes[index];
+        return node.op == OptimizedExpression::CONSTANT && node.value == value;
+    }
+
+    int makeBinary(OptimizedExpression::Op op, int left, int right) {
+        const OptimizedExpression::Node &l = result->nodes[left];
+        const OptimizedExpression::Node &r = result->nodes[right];
+
+        // Constant folding
+        if (l.op == OptimizedExpression::CONSTANT && r.op == OptimizedExpression::CONSTANT) {
+            return makeConstant(op == OptimizedExpression::SUM ? l.value + r.value : l.value * r.value);
+        }
+
+        // Algebraic simplifications
+        if (op == OptimizedExpression::SUM) {
+            if (isConstant(left, 0)) return right;
+            if (isConstant(right, 0)) return left;
+        } else {
+            if (isConstant(left, 0) || isConstant(right, 0)) return makeConstant(0);
+            if (isConstant(left, 1)) return right;
+            if (isConstant(right, 1)) return left;
+        }
+
+        // Canonical operand order for commutative operators
+        if (left > right) {
+            swap(left, right);
+        }
+        return makeNode(op, 0, left, right);
+    }
+
+    int convert(AbstractExpression *expression) {
+        auto seen = visited.find(expression);
+        if (seen != visited.end()) {
+            return seen->second;
+        }
+
+        int index;
+        if (auto constant = dynamic_cast<ConstantExpression *>(expression)) {
+            index = makeConstant(constant->getValue());
+        } else if (auto terminal = dynamic_cast<TerminalExpression *>(expression)) {
+            auto slot = variableSlots.find(terminal->getVariable());
+            if (slot == variableSlots.end()) {
+                slot = variableSlots.emplace(terminal->getVariable(), (int)result->variables.size()).first;
+                result->variables.push_back(terminal->getVariable());
+            }
+            index = makeNode(OptimizedExpression::VARIABLE, slot->second, -1, -1);
+        } else if (auto sum = dynamic_cast<SumNonTerminalExpression *>(expression)) {
+            int left = convert(sum->getLeft());
+            int right = convert(sum->getRight());
+            index = makeBinary(OptimizedExpression::SUM, left, right);
+        } else if (auto multiply = dynamic_cast<MultiplyNonTerminalExpression *>(expression)) {
+            int left = convert(multiply->getLeft());
+            int right = convert(multiply->getRight());
+            index = makeBinary(OptimizedExpression::MULTIPLY, left, right);
+        } else {
+            throw invalid_argument("ExpressionOptimizer: unsupported expression type");
+        }
+
+        visited[expression] = index;
+        return index;
+    }
+
+    // Keeps only the nodes reachable from the root, since simplification can orphan some.
+    void prune() {
+        vector<OptimizedExpression::Node> &nodes = result->nodes;
+        vector<bool> live(nodes.size(), false);
+        live[result->root] = true;
+        for (int i = nodes.size() - 1; i >= 0; i--) {
+            if (live[i] && (nodes[i].op == OptimizedExpression::SUM || nodes[i].op == OptimizedExpression::MULTIPLY)) {
+                live[nodes[i].left] = true;
+                live[nodes[i].right] = true;
+            }
+        }
+
+        vector<int> remap(nodes.size(), -1);
+        vector<OptimizedExpression::Node> kept;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            if (!live[i]) continue;
+            OptimizedExpression::Node node = nodes[i];
+            if (node.op == OptimizedExpression::SUM || node.op == OptimizedExpression::MULTIPLY) {
+                node.left = remap[node.left];
+                node.right = remap[node.right];
+            }
+            remap[i] = kept.size();
+            kept.push_back(node);
+        }
+        result->root = remap[result->root];
+        nodes.swap(kept);
+    }
+
+public:
+    /**
+     * @brief Compiles an expression tree into an optimized DAG.
+     *
+     * @param expression The root of the expression tree. The tree is not modified.
+     * @return A new OptimizedExpression owned by the caller.
+     */
+    OptimizedExpression *optimize(AbstractExpression *expression) {
+        result = new OptimizedExpression();
+        table.clear();
+        variableSlots.clear();
+        visited.clear();
+        result->root = convert(expression);
+        prune();
+        return result;
+    }
+};
+
+// Builds a formula with heavy subexpression reuse. Every term is written out with fresh nodes,
+// the way a hand-nested expression would be, even when it repeats an earlier term.
+AbstractExpression *buildTerm(mt19937 &rng, int variableCount) {
+    auto var = [&]() {
+        return new TerminalExpression("num" + to_string(rng() % variableCount + 1));
+    };
+    switch (rng() % 4) {
+    case 0: // num_i * num_j
+        return new MultiplyNonTerminalExpression(var(), var());
+    case 1: // (num_i * num_j) * (2 * 3)
+        return new MultiplyNonTerminalExpression(
+            new MultiplyNonTerminalExpression(var(), var()),
+            new MultiplyNonTerminalExpression(new ConstantExpression(2), new ConstantExpression(3)));
+    case 2: // (num_i + 0) * (num_j * 1)
+        return new MultiplyNonTerminalExpression(
+            new SumNonTerminalExpression(var(), new ConstantExpression(0)),
+            new MultiplyNonTerminalExpression(var(), new ConstantExpression(1)));
+    default: // num_i * num_j + num_k * num_l
+        return new SumNonTerminalExpression(
+            new MultiplyNonTerminalExpression(var(), var()),
+            new MultiplyNonTerminalExpression(var(), var()));
+    }
+}
+
+AbstractExpression *buildFormula(mt19937 &rng, int terms, int variableCount) {
+    if (terms == 1) {
+        return buildTerm(rng, variableCount);
+    }
+    return new SumNonTerminalExpression(buildFormula(rng, terms / 2, variableCount),
+                                        buildFormula(rng, terms - terms / 2, variableCount));
+}
+
+// Benchmarks the tree interpreter against the optimized DAG on the same generated formula.
+void benchmark(int terms, int variableCount, int iterations) {
+    mt19937 rng(terms);
+    Context *context = new Context();
+    for (int i = 1; i <= variableCount; i++) {
+        context->put("num" + to_string(i), i % 5 + 1);
+    }
+
+    AbstractExpression *formula = buildFormula(rng, terms, variableCount);
+    ExpressionOptimizer optimizer;
+    OptimizedExpression *optimized = optimizer.optimize(formula);
+
+    long long treeSum = 0, dagSum = 0;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        treeSum += formula->interpreter(context);
+    }
+    auto middle = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        dagSum += optimized->interpreter(context);
+    }
+    auto end = chrono::steady_clock::now();
+
+    double treeUs = chrono::duration<double, micro>(middle - start).count() / iterations;
+    double dagUs = chrono::duration<double, micro>(end - middle).count() / iterations;
+    cout << "terms=" << terms << " dagNodes=" << optimized->getNodeCount()
+         << " tree=" << treeUs << "us dag=" << dagUs << "us speedup=" << treeUs / dagUs
+         << (treeSum == dagSum ? " (results match)" : " (RESULTS DIFFER)") << endl;
+
+    delete optimized;
+    delete context;
+}
+
+// Main function
+/**
+ * @brief Demonstrates the expression optimizer on the classic example and benchmarks it on
+ * generated formulas with heavy subexpression reuse.
+ */
+int main() {
+    Context *context = new Context();
+    context->put("num1", 2);
+    context->put("num2", 3);
+    context->put("num3", 4);
+    context->put("num4", 5);
+
+    // (num1*num2) + (num1*num2)*(num3*num4) + num3*(1*0 + 1): num1*num2 is shared,
+    // 1*0 + 1 folds to 1 and num3*1 simplifies to num3.
+    AbstractExpression *expression = new SumNonTerminalExpression(
+        new SumNonTerminalExpression(
+            new MultiplyNonTerminalExpression(new TerminalExpression("num1"), new TerminalExpression("num2")),
+            new MultiplyNonTerminalExpression(
+                new MultiplyNonTerminalExpression(new TerminalExpression("num1"), new TerminalExpression("num2")),
+                new MultiplyNonTerminalExpression(new TerminalExpression("num3"), new TerminalExpression("num4")))),
+        new MultiplyNonTerminalExpression(
+            new TerminalExpression("num3"),
+            new SumNonTerminalExpression(
+                new MultiplyNonTerminalExpression(new ConstantExpression(1), new ConstantExpression(0)),
+                new ConstantExpression(1))));
+
+    ExpressionOptimizer optimizer;
+    OptimizedExpression *optimized = optimizer.optimize(expression);
+    cout << "Value of expression is " << expression->interpreter(context) << endl;
+    cout << "Value of optimized expression is " << optimized->interpreter(context)
+         << " using " << optimized->getNodeCount() << " nodes" << endl;
+
+    cout << "-----------------" << endl;
+    benchmark(64, 8, 200000);
+    benchmark(1024, 8, 20000);
+    benchmark(16384, 16, 200);
+
+    delete optimized;
+    delete context;
+    return 0;
+}
@@ -0,0 +1,497 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Interpreter Design Pattern with an Expression Parser:
+// The plain interpreter only works on trees that are hand-nested with `new`, and those nodes are
+// never freed. This variant parses text such as "num1*num2 + num3*num4" into the same kind of
+// expression tree. All nodes of one expression are allocated from an arena owned by that
+// expression, so the whole tree is released in one shot. A cache keyed by the normalized
+// expression text hands back an already compiled expression instead of parsing it again.
+
+// Context class
+// Stores variable values. Lookups accept a string_view so that terminals parsed out of a larger
+// text can be evaluated without building a temporary string.
+class Context {
+private:
+    map<string, int, less<>> m; // Stores variable-value pairs
+
+public:
+    Context() {
+        m.clear();
+    }
+
+    /**
+     * @brief Adds a variable and its value to the context.
+     *
+     * @param var The variable name as a string.
+     * @param val The value of the variable as an integer.
+     */
+    void put(string var, int val) {
+        m[var] = val;
+    }
+
+    /**
+     * @brief Retrieves the value of a variable from the context.
+     *
+     * @param var The variable name.
+     * @return The value of the variable, or 0 if it was never put.
+     */
+    int get(string_view var) {
+        auto it = m.find(var);
+        return it == m.end() ? 0 : it->second;
+    }
+};
+
+// AbstractExpression class
+// Interface for all expression types. Nodes live in an ExpressionArena and are never deleted
+// one by one, so the class deliberately has no virtual destructor.
+class AbstractExpression {
+public:
+    /**
+     * @brief Evaluates the expression using the provided context.
+     *
+     * @param context A pointer to the Context object containing variable values.
+     * @return The result of the interpretation as an integer.
+     */
+    virtual int interpreter(Context *context) = 0;
+};
+
+// ConstantExpression class
+// Represents a number literal in the expression text.
+class ConstantExpression : public AbstractExpression {
+    int value; // The literal value
+
+public:
+    ConstantExpression(int val) : value(val) {}
+
+    int interpreter(Context *context) {
+        return value;
+    }
+};
+
+// TerminalExpression class
+// Represents a variable. The name points into the text copy held by the same arena.
+class TerminalExpression : public AbstractExpression {
+    string_view variable; // The variable name
+
+public:
+    TerminalExpression(string_view var) : variable(var) {}
+
+    int interpreter(Context *context) {
+        return context->get(variable);
+    }
+};
+
+// MultiplyNonTerminalExpression class
+// This class represents a multiplication operation between two expressions.
+class MultiplyNonTerminalExpression : public AbstractExpression {
+    AbstractExpression *leftExpresion;  // The left-hand operand
+    AbstractExpression *rightExpression; // The right-hand operand
+
+public:
+    MultiplyNonTerminalExpression(AbstractExpression *l, AbstractExpression *r)
+        : leftExpresion(l), rightExpression(r) {}
+
+    int interpreter(Context *context) {
+        return (leftExpresion->interpreter(context) * rightExpression->interpreter(context));
+    }
+};
+
+// SumNonTerminalExpression class
+// This class represents an addition operation between two expressions.
+class SumNonTerminalExpression : public AbstractExpression {
+    AbstractExpression *leftExpresion;  // The left-hand operand
+    AbstractExpression *rightExpression; // The right-hand operand
+
+public:
+    SumNonTerminalExpression(AbstractExpression *l, AbstractExpression *r)
+        : leftExpresion(l), rightExpression(r) {}
+
+    int interpreter(Context *context) {
+        return (leftExpresion->interpreter(context) + rightExpression->interpreter(context));
+    }
+};
+
+// ExpressionArena class
+// A bump allocator. Memory is taken from blocks that double in size, starting small because most
+// expressions are short, and is only given back all at once. That is why everything placed in it
+// must be trivially destructible.
+class ExpressionArena {
+    static constexpr size_t FIRST_BLOCK_SIZE = 256;
+
+    vector<unique_ptr<char[]>> blocks; // Owned memory blocks
+    char *current;                     // Next free byte in the current block
+    size_t remaining;                  // Bytes left in the current block
+    size_t nextBlockSize;              // Size of the next block to allocate
+    size_t used;                       // Total bytes handed out
+
+    void *allocateBytes(size_t size, size_t alignment) {
+        size_t padding = (alignment - (reinterpret_cast<uintptr_t>(current) & (alignment - 1))) & (alignment - 1);
+        if (current == nullptr || padding + size > remaining) {
+            size_t blockSize = max(nextBlockSize, size + alignment);
+            nextBlockSize = blockSize * 2;
+            blocks.emplace_back(new char[blockSize]);
+            current = blocks.back().get();
+            remaining = blockSize;
+            padding = (alignment - (reinterpret_cast<uintptr_t>(current) & (alignment - 1))) & (alignment - 1);
+        }
+        void *memory = current + padding;
+        current += padding + size;
+        remaining -= padding + size;
+        used += size;
+        return memory;
+    }
+
+public:
+    ExpressionArena() : current(nullptr), remaining(0), nextBlockSize(FIRST_BLOCK_SIZE), used(0) {}
+
+    ExpressionArena(const ExpressionArena &) = delete;
+    ExpressionArena &operator=(const ExpressionArena &) = delete;
+
+    /**
+     * @brief Constructs an object of type T inside the arena.
+     *
+     * @return A pointer that stays valid until release() is called.
+     */
+    template <typename T, typename... Args>
+    T *create(Args &&...args) {
+        static_assert(is_trivially_destructible<T>::value, "arena objects are never destroyed individually");
+        return new (allocateBytes(sizeof(T), alignof(T))) T(forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Copies a piece of text into the arena.
+     *
+     * @return A view of the copy, valid until release() is called.
+     */
+    string_view copyText(string_view text) {
+        char *memory = static_cast<char *>(allocateBytes(text.size(), 1));
+        memcpy(memory, text.data(), text.size());
+        return string_view(memory, text.size());
+    }
+
+    // Frees every block in one shot.
+    void release() {
+        blocks.clear();
+        current = nullptr;
+        remaining = 0;
+        nextBlockSize = FIRST_BLOCK_SIZE;
+        used = 0;
+    }
+
+    size_t bytesUsed() {
+        return used;
+    }
+};
+
+// CompiledExpression class
+// A parsed expression together with the arena that holds its nodes. Destroying it releases the
+// whole tree at once.
+class CompiledExpression : public AbstractExpression {
+    ExpressionArena arena;    // Holds the nodes and the variable names
+    AbstractExpression *root; // Root of the parsed tree
+
+    friend class ExpressionParser;
+
+public:
+    CompiledExpression() : root(nullptr) {}
+
+    int interpreter(Context *context) {
+        return root->interpreter(context);
+    }
+
+    size_t getArenaBytes() {
+        return arena.bytesUsed();
+    }
+};
+
+// ExpressionParser class
+// A recursive descent parser for the grammar
+//     expression := term ('+' term)*
+//     term       := factor ('*' factor)*
+//     factor     := number | identifier | '(' expression ')'
+// Syntax errors are reported with invalid_argument, including the offending position.
+class ExpressionParser {
+    string_view text;        // Arena copy of the text being parsed
+    size_t position;         // Current read position
+    ExpressionArena *arena;  // Arena receiving the nodes
+
+    void skipSpaces() {
+        while (position < text.size() && isspace((unsigned char)text[position])) {
+            position++;
+        }
+    }
+
+    [[noreturn]] void fail(const string &reason) {
+        throw invalid_argument("ExpressionParser: " + reason + " at position " + to_string(position));
+    }
+
+    AbstractExpression *parseFactor() {
+        skipSpaces();
+        if (position >= text.size()) {
+            fail("unexpected end of expression");
+        }
+        char c = text[position];
+        if (c == '(') {
+            position++;
+            AbstractExpression *inner = parseExpression();
+            skipSpaces();
+            if (position >= text.size() || text[position] != ')') {
+                fail("expected ')'");
+            }
+            position++;
+            return inner;
+        }
+        if (isdigit((unsigned char)c)) {
+            long long value = 0;
+            while (position < text.size() && isdigit((unsigned char)text[position])) {
+                value = value * 10 + (text[position++] - '0');
+                if (value > INT_MAX) {
+                    fail("number too large");
+                }
+            }
+            return arena->create<ConstantExpression>((int)value);
+        }
+        if (isalpha((unsigned char)c) || c == '_') {
+            size_t start = position;
+            while (position < text.size() && (isalnum((unsigned char)text[position]) || text[position] == '_')) {
+                position++;
+            }
+            return arena->create<TerminalExpression>(text.substr(start, position - start));
+        }
+        fail(string("unexpected character '") + c + "'");
+    }
+
+    AbstractExpression *parseTerm() {
+        AbstractExpression *left = parseFactor();
+        skipSpaces();
+        while (position < text.size() && text[position] == '*') {
+            position++;
+            left = arena->create<MultiplyNonTerminalExpression>(left, parseFactor());
+            skipSpaces();
+        }
+        return left;
+    }
+
+    AbstractExpression *parseExpression() {
+        AbstractExpression *left = parseTerm();
+        skipSpaces();
+        while (position < text.size() && text[position] == '+') {
+            position++;
+            left = arena->create<SumNonTerminalExpression>(left, parseTerm());
+            skipSpaces();
+        }
+        return left;
+    }
+
+public:
+    /**
+     * @brief Parses an expression into a new CompiledExpression.
+     *
+     * @param source The expression text, e.g. "num1*num2 + num3*num4".
+     * @return The compiled expression, owned by the caller.
+     */
+    unique_ptr<CompiledExpression> parse(string_view source) {
+        unique_ptr<CompiledExpression> compiled(new CompiledExpression());
+        arena = &compiled->arena;
+        text = arena->copyText(source);
+        position = 0;
+        compiled->root = parseExpression();
+        skipSpaces();
+        if (position != text.size()) {
+            fail("unexpected trailing input");
+        }
+        return compiled;
+    }
+};
+
+// ExpressionCache class
+// Returns already compiled expressions, keyed by the expression text with the whitespace between
+// tokens removed, so "a*b + c" and "a * b+c" share one entry. Whitespace that separates two word
+// characters is kept as one space, since "num1 2" is two tokens and must not become "num12". On a
+// miss the original text is parsed, so the cache accepts and rejects exactly what the parser does.
+// The hit path normalizes into a reused buffer and does a single hash lookup, without allocating.
+class ExpressionCache {
+    unordered_map<string, shared_ptr<CompiledExpression>> cache; // Normalized text -> expression
+    ExpressionParser parser;
+    string key;  // Reused buffer for the normalized text
+    int hits;
+    int misses;
+
+    static bool isWordChar(char c) {
+        return isalnum((unsigned char)c) || c == '_';
+    }
+
+    void normalize(string_view text) {
+        key.clear();
+        bool spaceSkipped = false;
+        for (char c : text) {
+            if (isspace((unsigned char)c)) {
+                spaceSkipped = true;
+                continue;
+            }
+            if (spaceSkipped && !key.empty() && isWordChar(key.back()) && isWordChar(c)) {
+                key.push_back(' ');
+            }
+            key.push_back(c);
+            spaceSkipped = false;
+        }
+    }
+
+public:
+    ExpressionCache() : hits(0), misses(0) {}
+
+    /**
+     * @brief Returns the compiled form of an expression, parsing it only on a cache miss.
+     *
+     * @param text The expression text.
+     * @return A shared handle to the compiled expression.
+     */
+    shared_ptr<CompiledExpression> compile(string_view text) {
+        normalize(text);
+        auto it = cache.find(key);
+        if (it != cache.end()) {
+            hits++;
+            return it->second;
+        }
+        misses++;
+        shared_ptr<CompiledExpression> compiled = parser.parse(text);
+        cache.emplace(key, compiled);
+        return compiled;
+    }
+
+    int getHits() {
+        return hits;
+    }
+
+    int getMisses() {
+        return misses;
+    }
+};
+
+// Generates a rule file with one random sum-of-products expression per line.
+string generateRules(int ruleCount, int variableCount) {
+    mt19937 rng(42);
+    string rules;
+    for (int i = 0; i < ruleCount; i++) {
+        int terms = rng() % 6 + 2;
+        for (int t = 0; t < terms; t++) {
+            if (t > 0) rules += " + ";
+            int factors = rng() % 3 + 1;
+            for (int f = 0; f < factors; f++) {
+                if (f > 0) rules += "*";
+                if (rng() % 4 == 0) {
+                    rules += to_string(rng() % 9 + 1);
+                } else {
+                    rules += "num" + to_string(rng() % variableCount + 1);
+                }
+            }
+        }
+        rules += '\n';
+    }
+    return rules;
+}
+
+// Reports parse throughput over a large rule file and the latency of a cache hit.
+void benchmark(int ruleCount) {
+    string rules = generateRules(ruleCount, 64);
+    vector<string_view> lines;
+    size_t start = 0;
+    for (size_t i = 0; i < rules.size(); i++) {
+        if (rules[i] == '\n') {
+            lines.push_back(string_view(rules).substr(start, i - start));
+            start = i + 1;
+        }
+    }
+
+    Context *context = new Context();
+    for (int i = 1; i <= 64; i++) {
+        context->put("num" + to_string(i), i % 7);
+    }
+
+    ExpressionParser parser;
+    vector<unique_ptr<CompiledExpression>> compiled;
+    compiled.reserve(lines.size());
+    size_t arenaBytes = 0;
+    auto parseStart = chrono::steady_clock::now();
+    for (string_view line : lines) {
+        compiled.push_back(parser.parse(line));
+    }
+    auto parseEnd = chrono::steady_clock::now();
+    for (auto &expression : compiled) {
+        arenaBytes += expression->getArenaBytes();
+    }
+    auto releaseStart = chrono::steady_clock::now();
+    compiled.clear();
+    auto releaseEnd = chrono::steady_clock::now();
+
+    double parseSeconds = chrono::duration<double>(parseEnd - parseStart).count();
+    cout << "parsed " << lines.size() << " rules (" << rules.size() / 1024 << " KiB) in "
+         << parseSeconds * 1000 << " ms: " << lines.size() / parseSeconds / 1e6 << " M rules/s, "
+         << rules.size() / parseSeconds / (1 << 20) << " MiB/s, arena " << arenaBytes / lines.size()
+         << " bytes/rule, release " << chrono::duration<double, milli>(releaseEnd - releaseStart).count()
+         << " ms" << endl;
+
+    // Cache: the first pass fills it, the second pass is all hits.
+    ExpressionCache cache;
+    size_t hotRules = min<size_t>(lines.size(), 1000);
+    for (size_t i = 0; i < hotRules; i++) {
+        cache.compile(lines[i]);
+    }
+    const int rounds = 1000;
+    auto hitStart = chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < hotRules; i++) {
+            cache.compile(lines[i]);
+        }
+    }
+    auto hitEnd = chrono::steady_clock::now();
+    double hitNs = chrono::duration<double, nano>(hitEnd - hitStart).count() / (rounds * hotRules);
+    cout << "cache hit latency " << hitNs << " ns (hits=" << cache.getHits()
+         << ", misses=" << cache.getMisses() << ")" << endl;
+
+    delete context;
+}
+
+// Main function
+/**
+ * @brief Parses the classic example from text, shows the cache at work and runs the benchmark.
+ */
+int main() {
+    Context *context = new Context();
+    context->put("num1", 2);
+    context->put("num2", 3);
+    context->put("num3", 4);
+    context->put("num4", 5);
+
+    ExpressionCache cache;
+    shared_ptr<CompiledExpression> expression = cache.compile("num1*num2 + num3*num4");
+    cout << "Value of expression is " << expression->interpreter(context) << endl;
+
+    // Same expression written differently: served from the cache.
+    shared_ptr<CompiledExpression> again = cache.compile("num1 * num2+num3 * num4");
+    cout << "Same compiled expression: " << (again == expression ? "yes" : "no")
+         << " (hits=" << cache.getHits() << ", misses=" << cache.getMisses() << ")" << endl;
+
+    try {
+        cache.compile("num1 * (num2 + ");
+    } catch (const invalid_argument &e) {
+        cout << e.what() << endl;
+    }
+
+    // Whitespace between operands still separates tokens through the cache.
+    for (string_view text : {"num1 2", "1 2 * 3"}) {
+        try {
+            cache.compile(text);
+            cout << "\"" << text << "\" was accepted" << endl;
+        } catch (const invalid_argument &e) {
+            cout << "\"" << text << "\": " << e.what() << endl;
+        }
+    }
+
+    cout << "-----------------" << endl;
+    benchmark(200000);
+
+    delete context;
+    return 0;
+}
@@ -0,0 +1,330 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Interpreter Design Pattern with Expression Templates:
+// Formulas that are fixed at build time still pay for the runtime tree: one heap node per
+// operator and one virtual interpreter() call per node. This variant adds a compile-time front
+// end that mirrors TerminalExpression, SumNonTerminalExpression and MultiplyNonTerminalExpression.
+// Writing `num1*num2 + num3*num4` with static expressions produces a nested value type instead of
+// a tree, so the compiler sees the whole formula and emits straight-line code. The Context keeps
+// its usual semantics: values are looked up by name, and a missing variable reads as 0.
+
+// Context class
+// Stores variable values. slot() exposes the storage of a variable so that a static expression
+// can resolve all of its names once and then read the values directly. std::map never moves its
+// elements, so a slot stays valid for the lifetime of the Context and sees every later put().
+class Context {
+private:
+    map<string, int> m; // Stores variable-value pairs
+
+public:
+    Context() {
+        m.clear();
+    }
+
+    /**
+     * @brief Adds a variable and its value to the context.
+     *
+     * @param var The variable name as a string.
+     * @param val The value of the variable as an integer.
+     */
+    void put(string var, int val) {
+        m[var] = val;
+    }
+
+    /**
+     * @brief Retrieves the value of a variable from the context.
+     *
+     * @param var The variable name as a string.
+     * @return The value of the variable as an integer.
+     */
+    int get(string var) {
+        return m[var];
+    }
+
+    /**
+     * @brief Returns the storage of a variable, creating it with value 0 if needed.
+     *
+     * @param var The variable name as a string.
+     * @return A pointer that stays valid as long as the Context exists.
+     */
+    const int *slot(const string &var) {
+        return &m[var];
+    }
+
+    /**
+     * @brief Returns writable storage of a variable, for loops that update it without a name
+     * lookup per write. Writing through it has the same effect as put().
+     *
+     * @param var The variable name as a string.
+     * @return A pointer that stays valid as long as the Context exists.
+     */
+    int *mutableSlot(const string &var) {
+        return &m[var];
+    }
+};
+
+// ---------------------------------------------------------------------------------------------
+// Runtime expression tree, as in the plain interpreter. Used as the benchmark baseline.
+// ---------------------------------------------------------------------------------------------
+
+// AbstractExpression class
+// Interface for all runtime expression types.
+class AbstractExpression {
+public:
+    virtual int interpreter(Context *context) = 0;
+};
+
+// TerminalExpression class
+// Represents a variable, evaluated by looking it up in the context.
+class TerminalExpression : public AbstractExpression {
+    string variable; // The variable name
+
+public:
+    TerminalExpression(string var) : variable(var) {}
+
+    int interpreter(Context *context) {
+        return context->get(variable);
+    }
+};
+
+// MultiplyNonTerminalExpression class
+// This class represents a multiplication operation between two expressions.
+class MultiplyNonTerminalExpression : public AbstractExpression {
+    AbstractExpression *leftExpresion;  // The left-hand operand
+    AbstractExpression *rightExpression; // The right-hand operand
+
+public:
+    MultiplyNonTerminalExpression(AbstractExpression *l, AbstractExpression *r)
+        : leftExpresion(l), rightExpression(r) {}
+
+    int interpreter(Context *context) {
+        return (leftExpresion->interpreter(context) * rightExpression->interpreter(context));
+    }
+};
+
+// SumNonTerminalExpression class
+// This class represents an addition operation between two expressions.
+class SumNonTerminalExpression : public AbstractExpression {
+    AbstractExpression *leftExpresion;  // The left-hand operand
+    AbstractExpression *rightExpression; // The right-hand operand
+
+public:
+    SumNonTerminalExpression(AbstractExpression *l, AbstractExpression *r)
+        : leftExpresion(l), rightExpression(r) {}
+
+    int interpreter(Context *context) {
+        return (leftExpresion->interpreter(context) + rightExpression->interpreter(context));
+    }
+};
+
+// ---------------------------------------------------------------------------------------------
+// Compile-time front end. Every static expression provides:
+//   interpreter(context) - evaluates with name lookups, like the runtime tree but fully inlined
+//   bind(context)        - resolves every name once and returns a callable that evaluates the
+//                          formula from the bound slots with plain loads and arithmetic
+// ---------------------------------------------------------------------------------------------
+
+// StaticExpression class
+// CRTP base used only to tag static expression types, so the operators below do not apply to
+// unrelated types.
+template <typename Derived>
+struct StaticExpression {
+    const Derived &self() const {
+        return static_cast<const Derived &>(*this);
+    }
+};
+
+// Bound form of a terminal: a direct pointer to the variable's storage.
+struct BoundTerminal {
+    const int *value;
+
+    int operator()() const {
+        return *value;
+    }
+};
+
+// Bound form of a sum.
+template <typename L, typename R>
+struct BoundSum {
+    L left;
+    R right;
+
+    int operator()() const {
+        return left() + right();
+    }
+};
+
+// Bound form of a multiplication.
+template <typename L, typename R>
+struct BoundMultiply {
+    L left;
+    R right;
+
+    int operator()() const {
+        return left() * right();
+    }
+};
+
+// StaticTerminalExpression class
+// Compile-time counterpart of TerminalExpression.
+class StaticTerminalExpression : public StaticExpression<StaticTerminalExpression> {
+    const char *variable; // The variable name
+
+public:
+    constexpr StaticTerminalExpression(const char *var) : variable(var) {}
+
+    int interpreter(Context *context) const {
+        return context->get(variable);
+    }
+
+    BoundTerminal bind(Context *context) const {
+        return BoundTerminal{context->slot(variable)};
+    }
+};
+
+// StaticSumExpression class
+// Compile-time counterpart of SumNonTerminalExpression. Operands are held by value.
+template <typename L, typename R>
+class StaticSumExpression : public StaticExpression<StaticSumExpression<L, R>> {
+    L leftExpresion;   // The left-hand operand
+    R rightExpression; // The right-hand operand
+
+public:
+    constexpr StaticSumExpression(const L &l, const R &r) : leftExpresion(l), rightExpression(r) {}
+
+    int interpreter(Context *context) const {
+        return leftExpresion.interpreter(context) + rightExpression.interpreter(context);
+    }
+
+    auto bind(Context *context) const {
+        auto l = leftExpresion.bind(context);
+        auto r = rightExpression.bind(context);
+        return BoundSum<decltype(l), decltype(r)>{l, r};
+    }
+};
+
+// StaticMultiplyExpression class
+// Compile-time counterpart of MultiplyNonTerminalExpression. Operands are held by value.
+template <typename L, typename R>
+class StaticMultiplyExpression : public StaticExpression<StaticMultiplyExpression<L, R>> {
+    L leftExpresion;   // The left-hand operand
+    R rightExpression; // The right-hand operand
+
+public:
+    constexpr StaticMultiplyExpression(const L &l, const R &r) : leftExpresion(l), rightExpression(r) {}
+
+    int interpreter(Context *context) const {
+        return leftExpresion.interpreter(context) * rightExpression.interpreter(context);
+    }
+
+    auto bind(Context *context) const {
+        auto l = leftExpresion.bind(context);
+        auto r = rightExpression.bind(context);
+        return BoundMultiply<decltype(l), decltype(r)>{l, r};
+    }
+};
+
+template <typename L, typename R>
+constexpr StaticSumExpression<L, R> operator+(const StaticExpression<L> &l, const StaticExpression<R> &r) {
+    return StaticSumExpression<L, R>(l.self(), r.self());
+}
+
+template <typename L, typename R>
+constexpr StaticMultiplyExpression<L, R> operator*(const StaticExpression<L> &l, const StaticExpression<R> &r) {
+    return StaticMultiplyExpression<L, R>(l.self(), r.self());
+}
+
+// RuntimeBuilder class
+// Lets the benchmark write a formula once as a generic function and get the runtime tree from the
+// same source text as the static expression.
+struct RuntimeBuilder {
+    AbstractExpression *expression;
+};
+
+RuntimeBuilder operator+(RuntimeBuilder l, RuntimeBuilder r) {
+    return RuntimeBuilder{new SumNonTerminalExpression(l.expression, r.expression)};
+}
+
+RuntimeBuilder operator*(RuntimeBuilder l, RuntimeBuilder r) {
+    return RuntimeBuilder{new MultiplyNonTerminalExpression(l.expression, r.expression)};
+}
+
+// The main() example.
+template <typename T>
+auto smallFormula(T num1, T num2, T num3, T num4) {
+    return num1 * num2 + num3 * num4;
+}
+
+// A larger formula with 31 operators over 8 variables.
+template <typename T>
+auto largeFormula(T a, T b, T c, T d, T e, T f, T g, T h) {
+    auto left = (a * b + c * d) * (e * f + g * h) + (a * c + b * d) * (e * g + f * h);
+    auto right = (a * h + b * g) * (c * f + d * e) + (a * e + b * f) * (c * g + d * h);
+    return left + right;
+}
+
+// Times `iterations` evaluations of `evaluate`, changing num1 between them through its slot so
+// that the compiler cannot hoist the work out of the loop.
+template <typename F>
+double timeNs(Context *context, int iterations, long long &checksum, F evaluate) {
+    int *num1 = context->mutableSlot("num1");
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        *num1 = i & 7;
+        checksum += evaluate();
+    }
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double, nano>(end - start).count() / iterations;
+}
+
+template <typename S>
+void benchmark(const string &name, Context *context, AbstractExpression *runtime, const S &formula, int iterations) {
+    auto bound = formula.bind(context);
+    long long runtimeSum = 0, staticSum = 0, boundSum = 0;
+    double runtimeNs = timeNs(context, iterations, runtimeSum, [&]() { return runtime->interpreter(context); });
+    double staticNs = timeNs(context, iterations, staticSum, [&]() { return formula.interpreter(context); });
+    double boundNs = timeNs(context, iterations, boundSum, [&]() { return bound(); });
+    cout << name << ": runtime tree=" << runtimeNs << "ns static=" << staticNs << "ns static bound="
+         << boundNs << "ns"
+         << (runtimeSum == staticSum && staticSum == boundSum ? " (results match)" : " (RESULTS DIFFER)") << endl;
+}
+
+// Main function
+/**
+ * @brief Evaluates the classic example as a static expression and benchmarks it, and a larger
+ * formula, against the runtime tree.
+ */
+int main() {
+    Context *context = new Context();
+    context->put("num1", 2);
+    context->put("num2", 3);
+    context->put("num3", 4);
+    context->put("num4", 5);
+
+    StaticTerminalExpression num1("num1"), num2("num2"), num3("num3"), num4("num4");
+    auto expression = num1 * num2 + num3 * num4; // No heap nodes, no virtual calls
+    cout << "Value of expression is " << expression.interpreter(context) << endl;
+
+    auto bound = expression.bind(context);
+    context->put("num1", 10); // Bound slots see later updates
+    cout << "Value of bound expression after num1=10 is " << bound() << endl;
+
+    cout << "-----------------" << endl;
+    for (int i = 5; i <= 8; i++) {
+        context->put("num" + to_string(i), i);
+    }
+    StaticTerminalExpression num5("num5"), num6("num6"), num7("num7"), num8("num8");
+
+    auto var = [](const char *name) { return RuntimeBuilder{new TerminalExpression(name)}; };
+    AbstractExpression *smallRuntime = smallFormula(var("num1"), var("num2"), var("num3"), var("num4")).expression;
+    AbstractExpression *largeRuntime = largeFormula(var("num1"), var("num2"), var("num3"), var("num4"),
+                                                    var("num5"), var("num6"), var("num7"), var("num8")).expression;
+
+    benchmark("main() example", context, smallRuntime, smallFormula(num1, num2, num3, num4), 5000000);
+    benchmark("31-operator formula", context, largeRuntime,
+              largeFormula(num1, num2, num3, num4, num5, num6, num7, num8), 1000000);
+
+    delete context;
+    return 0;
+}
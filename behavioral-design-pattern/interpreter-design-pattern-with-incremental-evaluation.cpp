@@ -0,0 +1,369 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Interpreter Design Pattern with Incremental Evaluation:
+// When thousands of derived expressions stay live while single variables change, re-running
+// interpreter() on every expression after each Context::put() repeats almost all of the work.
+// In this variant every expression node caches its last value. The Context remembers which
+// terminal expressions read each variable, so put() only marks the affected terminals and their
+// ancestors dirty. interpreter() recomputes a node lazily, and only if it is dirty.
+// These links are undone on destruction: a terminal unsubscribes from its context, a non-terminal
+// leaves its operands' parent lists, and a context that dies first unbinds its terminals.
+// Non-terminals do not own their operands; delete a parent before the operands it uses.
+
+class TerminalExpression;
+
+// Context class
+// Stores variable values together with the terminal expressions that read each variable.
+class Context {
+private:
+    // A variable's value and the terminals that depend on it
+    struct Slot {
+        int value = 0;
+        vector<TerminalExpression *> readers;
+    };
+
+    map<string, Slot> m; // Stores variable-value pairs
+
+public:
+    Context() {
+        m.clear();
+    }
+
+    /**
+     * @brief Unbinds every subscribed terminal, so it can outlive the context.
+     */
+    ~Context();
+
+    /**
+     * @brief Sets a variable and dirties every expression that reads it.
+     *
+     * Writing the value a variable already has does not dirty anything.
+     *
+     * @param var The variable name as a string.
+     * @param val The value of the variable as an integer.
+     */
+    void put(string var, int val);
+
+    /**
+     * @brief Retrieves the value of a variable from the context.
+     *
+     * @param var The variable name as a string.
+     * @return The value of the variable as an integer.
+     */
+    int get(const string &var) {
+        return m[var].value;
+    }
+
+    /**
+     * @brief Records that an expression reads a variable, so that put() can dirty it.
+     *
+     * @param var The variable name as a string.
+     * @param reader The expression reading the variable.
+     */
+    void subscribe(const string &var, TerminalExpression *reader) {
+        m[var].readers.push_back(reader);
+    }
+
+    /**
+     * @brief Forgets a reader recorded by subscribe(), when the reader is destroyed.
+     *
+     * @param var The variable name as a string.
+     * @param reader The expression that read the variable.
+     */
+    void unsubscribe(const string &var, TerminalExpression *reader) {
+        vector<TerminalExpression *> &readers = m[var].readers;
+        readers.erase(remove(readers.begin(), readers.end(), reader), readers.end());
+    }
+};
+
+// AbstractExpression class
+// Base for all expressions. interpreter() returns the cached value of a clean node and only calls
+// evaluate() on a dirty one. Every node knows its parents so a change can be pushed upwards.
+class AbstractExpression {
+    vector<AbstractExpression *> parents; // Expressions using this one as an operand
+    int cachedValue;                      // Value from the last evaluation
+    bool dirty;                           // True if cachedValue is out of date
+
+protected:
+    /**
+     * @brief Computes the value of this node, reading operands through interpreter().
+     */
+    virtual int evaluate(Context *context) = 0;
+
+    // Registers parent as a user of child, so child's changes reach it.
+    static void addParent(AbstractExpression *child, AbstractExpression *parent) {
+        child->parents.push_back(parent);
+    }
+
+    // Undoes addParent(), when parent is destroyed.
+    static void removeParent(AbstractExpression *child, AbstractExpression *parent) {
+        vector<AbstractExpression *> &parents = child->parents;
+        parents.erase(remove(parents.begin(), parents.end(), parent), parents.end());
+    }
+
+public:
+    AbstractExpression() : cachedValue(0), dirty(true) {}
+
+    /**
+     * @brief Evaluates the expression, reusing the cached value if nothing it depends on changed.
+     *
+     * @param context A pointer to the Context object containing variable values.
+     * @return The result of the interpretation as an integer.
+     */
+    int interpreter(Context *context) {
+        if (dirty) {
+            cachedValue = evaluate(context);
+            dirty = false;
+        }
+        return cachedValue;
+    }
+
+    /**
+     * @brief Evaluates the whole tree from scratch, ignoring all caches, the way the plain
+     * interpreter does. Used as the benchmark baseline.
+     */
+    virtual int recompute(Context *context) = 0;
+
+    /**
+     * @brief Marks this node and all of its ancestors dirty.
+     *
+     * Propagation stops at nodes that are already dirty, since their ancestors must be too.
+     */
+    void markDirty() {
+        if (dirty) {
+            return;
+        }
+        dirty = true;
+        for (auto parent : parents) {
+            parent->markDirty();
+        }
+    }
+
+    virtual ~AbstractExpression() = default;
+};
+
+// TerminalExpression class
+// Represents a variable. The first evaluation subscribes it to the context, after which the
+// expression is bound to that context.
+class TerminalExpression : public AbstractExpression {
+    string variable;        // The variable name
+    Context *boundContext;  // Context this terminal is subscribed to
+
+protected:
+    int evaluate(Context *context) override {
+        if (boundContext == nullptr) {
+            context->subscribe(variable, this);
+            boundContext = context;
+        } else if (boundContext != context) {
+            throw invalid_argument("TerminalExpression: expression is already bound to another context");
+        }
+        return context->get(variable);
+    }
+
+public:
+    TerminalExpression(string var) : variable(var), boundContext(nullptr) {}
+
+    ~TerminalExpression() {
+        if (boundContext != nullptr) {
+            boundContext->unsubscribe(variable, this);
+        }
+    }
+
+    int recompute(Context *context) override {
+        return context->get(variable);
+    }
+
+    /**
+     * @brief Called by a context being destroyed: the next evaluation binds to a new context.
+     */
+    void unbind() {
+        boundContext = nullptr;
+        markDirty();
+    }
+};
+
+Context::~Context() {
+    for (auto &entry : m) {
+        for (auto reader : entry.second.readers) {
+            reader->unbind();
+        }
+    }
+}
+
+void Context::put(string var, int val) {
+    Slot &slot = m[var];
+    if (slot.value == val) {
+        return;
+    }
+    slot.value = val;
+    for (auto reader : slot.readers) {
+        reader->markDirty();
+    }
+}
+
+// MultiplyNonTerminalExpression class
+// This class represents a multiplication operation between two expressions.
+class MultiplyNonTerminalExpression : public AbstractExpression {
+    AbstractExpression *leftExpresion;  // The left-hand operand
+    AbstractExpression *rightExpression; // The right-hand operand
+
+protected:
+    int evaluate(Context *context) override {
+        return (leftExpresion->interpreter(context) * rightExpression->interpreter(context));
+    }
+
+public:
+    MultiplyNonTerminalExpression(AbstractExpression *l, AbstractExpression *r)
+        : leftExpresion(l), rightExpression(r) {
+        addParent(l, this);
+        addParent(r, this);
+    }
+
+    ~MultiplyNonTerminalExpression() {
+        removeParent(leftExpresion, this);
+        removeParent(rightExpression, this);
+    }
+
+    int recompute(Context *context) override {
+        return (leftExpresion->recompute(context) * rightExpression->recompute(context));
+    }
+};
+
+// SumNonTerminalExpression class
+// This class represents an addition operation between two expressions.
+class SumNonTerminalExpression : public AbstractExpression {
+    AbstractExpression *leftExpresion;  // The left-hand operand
+    AbstractExpression *rightExpression; // The right-hand operand
+
+protected:
+    int evaluate(Context *context) override {
+        return (leftExpresion->interpreter(context) + rightExpression->interpreter(context));
+    }
+
+public:
+    SumNonTerminalExpression(AbstractExpression *l, AbstractExpression *r)
+        : leftExpresion(l), rightExpression(r) {
+        addParent(l, this);
+        addParent(r, this);
+    }
+
+    ~SumNonTerminalExpression() {
+        removeParent(leftExpresion, this);
+        removeParent(rightExpression, this);
+    }
+
+    int recompute(Context *context) override {
+        return (leftExpresion->recompute(context) + rightExpression->recompute(context));
+    }
+};
+
+// Builds a derived expression: a sum of a few products of random variables.
+AbstractExpression *buildDerived(mt19937 &rng, int variableCount) {
+    auto var = [&]() {
+        return new TerminalExpression("v" + to_string(rng() % variableCount));
+    };
+    AbstractExpression *expression = new MultiplyNonTerminalExpression(var(), var());
+    int terms = rng() % 4 + 1;
+    for (int t = 0; t < terms; t++) {
+        expression = new SumNonTerminalExpression(expression, new MultiplyNonTerminalExpression(var(), var()));
+    }
+    return expression;
+}
+
+// Changes one variable out of variableCount and then reads every derived expression, comparing
+// full re-interpretation with incremental re-evaluation.
+void benchmark(int variableCount, int expressionCount, int updates) {
+    mt19937 rng(7);
+    Context *context = new Context();
+    for (int i = 0; i < variableCount; i++) {
+        context->put("v" + to_string(i), i % 10);
+    }
+    vector<AbstractExpression *> expressions;
+    for (int i = 0; i < expressionCount; i++) {
+        expressions.push_back(buildDerived(rng, variableCount));
+    }
+    for (auto expression : expressions) {
+        expression->interpreter(context); // Initial evaluation binds the terminals
+    }
+
+    vector<string> names;
+    vector<int> newValues;
+    for (int u = 0; u < updates; u++) {
+        names.push_back("v" + to_string(rng() % variableCount));
+        newValues.push_back(rng() % 10);
+    }
+
+    long long fullSum = 0, incrementalSum = 0;
+    auto fullStart = chrono::steady_clock::now();
+    for (int u = 0; u < updates; u++) {
+        context->put(names[u], newValues[u]);
+        for (auto expression : expressions) {
+            fullSum += expression->recompute(context);
+        }
+    }
+    auto fullEnd = chrono::steady_clock::now();
+
+    // Replay the same updates from the same starting values for the incremental path.
+    for (int i = 0; i < variableCount; i++) {
+        context->put("v" + to_string(i), i % 10);
+    }
+    auto incrementalStart = chrono::steady_clock::now();
+    for (int u = 0; u < updates; u++) {
+        context->put(names[u], newValues[u]);
+        for (auto expression : expressions) {
+            incrementalSum += expression->interpreter(context);
+        }
+    }
+    auto incrementalEnd = chrono::steady_clock::now();
+
+    double fullUs = chrono::duration<double, micro>(fullEnd - fullStart).count() / updates;
+    double incrementalUs = chrono::duration<double, micro>(incrementalEnd - incrementalStart).count() / updates;
+    cout << "variables=" << variableCount << " expressions=" << expressionCount
+         << " update-then-read: full=" << fullUs << "us incremental=" << incrementalUs
+         << "us speedup=" << fullUs / incrementalUs
+         << (fullSum == incrementalSum ? " (results match)" : " (RESULTS DIFFER)") << endl;
+
+    delete context;
+}
+
+// Main function
+/**
+ * @brief Demonstrates that only expressions depending on a changed variable are recomputed,
+ * then benchmarks update-then-read latency with 10k variables.
+ */
+int main() {
+    Context *context = new Context();
+    context->put("num1", 2);
+    context->put("num2", 3);
+    context->put("num3", 4);
+    context->put("num4", 5);
+
+    AbstractExpression *num1 = new TerminalExpression("num1");
+    AbstractExpression *num2 = new TerminalExpression("num2");
+    AbstractExpression *num3 = new TerminalExpression("num3");
+    AbstractExpression *num4 = new TerminalExpression("num4");
+    AbstractExpression *expression1 = new MultiplyNonTerminalExpression(num1, num2);
+    AbstractExpression *expression2 = new MultiplyNonTerminalExpression(num3, num4);
+    AbstractExpression *expression3 = new SumNonTerminalExpression(expression1, expression2);
+
+    cout << "Value of expression is " << expression3->interpreter(context) << endl;
+
+    // Only num1*num2 and the sum are recomputed; num3*num4 stays cached.
+    context->put("num1", 10);
+    cout << "Value of expression after num1=10 is " << expression3->interpreter(context) << endl;
+
+    // Parents before operands. The terminals unsubscribe, so later puts touch no freed node.
+    for (AbstractExpression *node : {expression3, expression1, expression2, num1, num2, num3, num4}) {
+        delete node;
+    }
+    context->put("num1", 11);
+    context->put("num3", 12);
+    cout << "Expression deleted; later puts are safe" << endl;
+
+    cout << "-----------------" << endl;
+    benchmark(10000, 10000, 100);
+
+    delete context;
+    return 0;
+}
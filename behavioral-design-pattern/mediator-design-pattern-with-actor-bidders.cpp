@@ -0,0 +1,675 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Mediator Design Pattern with Actor Bidders:
+// In the classic version Bidder::placeBid calls into the AuctionMediator, which calls back into
+// every other Bidder on the same stack: nothing runs in parallel and one slow bidder blocks the
+// whole auction. In this variant the mediator and every bidder are actors. Each actor owns a
+// lock-free mailbox, the mediator posts messages instead of calling bidders directly, and a
+// work-stealing Scheduler runs the actors whose mailboxes are non-empty across all cores. An actor
+// is only ever run by one worker at a time, so bidders still see their notifications one by one.
+
+// Abstract interface for a bidder in the auction
+class IBidder {
+public:
+    virtual void placeBid(int bidAmount) = 0;                // Places a bid
+    virtual void receiveBidNotification(string bidderName, int bidAmount) = 0; // Receives notification of other bids
+    virtual string getName() = 0;                           // Returns the name of the bidder
+    virtual ~IBidder() = default;
+};
+
+// Abstract interface for the mediator
+class IAuctionMediator {
+public:
+    virtual void addBidder(IBidder *bidder) = 0;            // Adds a bidder to the auction
+    virtual void placeBid(IBidder *bidder, int bidAmount) = 0; // Handles the bid placement
+    virtual ~IAuctionMediator() = default;
+};
+
+// Concrete implementation of a bidder
+class Bidder : public IBidder {
+    string name;                   // Name of the bidder
+    IAuctionMediator *auctionMediator; // Reference to the mediator
+
+public:
+    Bidder(string nm, IAuctionMediator *am) : name(nm), auctionMediator(am) {
+        auctionMediator->addBidder(this); // Register bidder with the mediator
+    }
+
+    void placeBid(int bidAmount) override {
+        cout << name << " placed a bid of " << bidAmount << endl;
+        auctionMediator->placeBid(this, bidAmount); // Posts the bid, returns immediately
+    }
+
+    void receiveBidNotification(string bidderName, int bidAmount) override {
+        cout << name << " received notification that " << bidderName << " placed a bid of " << bidAmount << endl;
+    }
+
+    string getName() override {
+        return name;
+    }
+};
+
+// A bidder that only counts its notifications, used by the benchmark. An actor is never run by
+// two workers at once, so a plain counter is enough.
+class CountingBidder : public IBidder {
+    string name;
+    IAuctionMediator *auctionMediator;
+
+public:
+    long long notifications = 0;
+
+    CountingBidder(string nm, IAuctionMediator *am) : name(nm), auctionMediator(am) {
+        auctionMediator->addBidder(this);
+    }
+
+    void placeBid(int bidAmount) override {
+        auctionMediator->placeBid(this, bidAmount);
+    }
+
+    void receiveBidNotification(string bidderName, int bidAmount) override {
+        notifications++;
+    }
+
+    string getName() override {
+        return name;
+    }
+};
+
+// A message in an actor's mailbox.
+struct Message {
+    enum Kind { PLACE_BID, BID_NOTIFICATION };
+
+    Kind kind;
+    IBidder *bidder;        // The bidder who placed the bid
+    int bidAmount;
+    long long postedAt;     // steady_clock nanoseconds, for latency measurement
+    atomic<Message *> next;
+};
+
+static long long nowNanos() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Multi-producer single-consumer mailbox (Vyukov's intrusive queue). Any thread may post with a
+// single atomic exchange; only the worker currently running the actor pops.
+class Mailbox {
+    alignas(64) atomic<Message *> head;
+    alignas(64) atomic<Message *> tail; // Written only by the consumer, but read by empty() from
+                                        // a worker that has just given the actor up
+    Message stub;
+
+    void setTail(Message *message) {
+        tail.store(message, memory_order_release);
+    }
+
+public:
+    Mailbox() {
+        stub.next.store(nullptr);
+        head.store(&stub);
+        tail.store(&stub);
+    }
+
+    void push(Message *message) {
+        message->next.store(nullptr, memory_order_relaxed);
+        Message *previous = head.exchange(message);
+        previous->next.store(message, memory_order_release);
+    }
+
+    // Returns the oldest message, or nullptr if the mailbox is empty or a push is half done.
+    Message *pop() {
+        Message *first = tail.load(memory_order_relaxed); // The consumer reads its own writes
+        Message *next = first->next.load(memory_order_acquire);
+        if (first == &stub) {
+            if (next == nullptr) {
+                return nullptr;
+            }
+            setTail(next);
+            first = next;
+            next = next->next.load(memory_order_acquire);
+        }
+        if (next != nullptr) {
+            setTail(next);
+            return first;
+        }
+        if (first != head.load(memory_order_acquire)) {
+            return nullptr;
+        }
+        push(&stub);
+        next = first->next.load(memory_order_acquire);
+        if (next != nullptr) {
+            setTail(next);
+            return first;
+        }
+        return nullptr;
+    }
+
+    // True only when every pushed message has been popped: the tail is back on the stub and no
+    // push has started since. A message that is the last one in the queue still counts, since
+    // pop() returns it by re-linking the stub behind it. False as soon as any push has started,
+    // including one that pop() cannot return yet. Safe to call from any thread; the answer may be
+    // stale if another worker is consuming meanwhile.
+    bool empty() {
+        return tail.load(memory_order_acquire) == &stub && head.load() == &stub;
+    }
+};
+
+// Latency histogram with 8 sub-buckets per power of two of nanoseconds.
+class LatencyHistogram {
+    static const int SUB_BUCKETS = 8;
+    array<long long, 64 * SUB_BUCKETS> counts{};
+
+    static int bucketOf(long long nanos) {
+        if (nanos < SUB_BUCKETS) {
+            return (int)max(nanos, 0LL);
+        }
+        int msb = 63 - __builtin_clzll((unsigned long long)nanos);
+        int sub = (int)((nanos >> (msb - 3)) & (SUB_BUCKETS - 1));
+        return msb * SUB_BUCKETS + sub;
+    }
+
+    static long long upperBound(int bucket) {
+        int msb = bucket / SUB_BUCKETS;
+        int sub = bucket % SUB_BUCKETS;
+        if (msb < 3) {
+            return bucket;
+        }
+        return (1LL << msb) + ((long long)(sub + 1) << (msb - 3));
+    }
+
+public:
+    void record(long long nanos) {
+        counts[bucketOf(nanos)]++;
+    }
+
+    void merge(const LatencyHistogram &other) {
+        for (size_t i = 0; i < counts.size(); i++) {
+            counts[i] += other.counts[i];
+        }
+    }
+
+    long long total() const {
+        long long sum = 0;
+        for (long long count : counts) {
+            sum += count;
+        }
+        return sum;
+    }
+
+    // Returns an upper bound for the given quantile, in nanoseconds.
+    long long percentile(double quantile) const {
+        long long target = (long long)ceil(quantile * total());
+        long long seen = 0;
+        for (size_t i = 0; i < counts.size(); i++) {
+            seen += counts[i];
+            if (seen >= target && counts[i] > 0) {
+                return upperBound(i);
+            }
+        }
+        return 0;
+    }
+};
+
+class Scheduler;
+
+// An actor: a mailbox plus a flag telling whether it is queued on (or running in) the scheduler.
+// post() schedules the actor only on the empty-to-non-empty transition, so each actor is in at
+// most one run queue and is run by at most one worker at a time.
+class Actor {
+    Mailbox mailbox;
+    atomic<bool> scheduled;
+    Scheduler *scheduler;
+
+protected:
+    virtual void receive(Message *message) = 0;
+
+public:
+    static const int BATCH_SIZE = 64; // Messages handled per run before yielding the worker
+
+    Actor(Scheduler *s) : scheduled(false), scheduler(s) {}
+    virtual ~Actor() = default;
+
+    void post(Message *message);
+
+    // Handles up to BATCH_SIZE messages; returns how many were handled.
+    int run();
+};
+
+// Work-stealing deque (Chase-Lev) of fixed capacity. The owning worker pushes and pops at the
+// bottom; other workers steal from the top. The race between pop() and steal() for the last
+// element is settled by sequentially consistent accesses to top and bottom plus a CAS on top.
+class WorkStealingDeque {
+    static const long long CAPACITY = 1 << 17;
+
+    alignas(64) atomic<long long> top;
+    alignas(64) atomic<long long> bottom;
+    unique_ptr<atomic<Actor *>[]> buffer;
+
+public:
+    WorkStealingDeque() : top(0), bottom(0), buffer(new atomic<Actor *>[CAPACITY]) {}
+
+    // Owner only. Returns false when the deque is full.
+    bool push(Actor *actor) {
+        long long b = bottom.load(memory_order_relaxed);
+        long long t = top.load(memory_order_acquire);
+        if (b - t >= CAPACITY) {
+            return false;
+        }
+        buffer[b & (CAPACITY - 1)].store(actor, memory_order_relaxed);
+        bottom.store(b + 1, memory_order_release);
+        return true;
+    }
+
+    // Owner only.
+    Actor *pop() {
+        long long b = bottom.load(memory_order_relaxed) - 1;
+        bottom.store(b, memory_order_seq_cst);
+        long long t = top.load(memory_order_seq_cst);
+        if (t > b) {
+            bottom.store(b + 1, memory_order_relaxed);
+            return nullptr;
+        }
+        Actor *actor = buffer[b & (CAPACITY - 1)].load(memory_order_relaxed);
+        if (t == b) { // Last element: race against thieves for it
+            if (!top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed)) {
+                actor = nullptr;
+            }
+            bottom.store(b + 1, memory_order_relaxed);
+        }
+        return actor;
+    }
+
+    // Any thread. Returns nullptr if the deque is empty or the steal lost a race.
+    Actor *steal() {
+        long long t = top.load(memory_order_seq_cst);
+        long long b = bottom.load(memory_order_seq_cst);
+        if (t >= b) {
+            return nullptr;
+        }
+        Actor *actor = buffer[t & (CAPACITY - 1)].load(memory_order_relaxed);
+        if (!top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed)) {
+            return nullptr;
+        }
+        return actor;
+    }
+};
+
+// Runs actors on a fixed pool of workers. An actor scheduled from a worker goes to the bottom of
+// that worker's deque; an actor scheduled from any other thread goes to a shared injection queue.
+// Idle workers take from their own deque, then the injection queue, then steal from the others.
+class Scheduler {
+    struct alignas(64) Worker {
+        WorkStealingDeque deque;
+        atomic<long long> posted{0};      // Messages posted from this worker
+        atomic<long long> handled{0};     // Messages handled on this worker
+        LatencyHistogram latency;         // Post-to-receive latency of messages handled here
+        thread runner;
+    };
+
+    vector<unique_ptr<Worker>> workers;
+    mutex injectionMutex;
+    deque<Actor *> injected;
+    atomic<long long> externalPosted;     // Messages posted from threads outside the pool
+    atomic<bool> stopping;
+
+    static thread_local Worker *currentWorker;
+    static thread_local Scheduler *currentScheduler;
+
+    Actor *takeInjected() {
+        lock_guard<mutex> lock(injectionMutex);
+        if (injected.empty()) {
+            return nullptr;
+        }
+        Actor *actor = injected.front();
+        injected.pop_front();
+        return actor;
+    }
+
+    Actor *findWork(size_t self, mt19937 &rng) {
+        Actor *actor = workers[self]->deque.pop();
+        if (actor != nullptr) {
+            return actor;
+        }
+        actor = takeInjected();
+        if (actor != nullptr) {
+            return actor;
+        }
+        size_t count = workers.size();
+        size_t start = rng() % count;
+        for (size_t i = 0; i < count; i++) {
+            size_t victim = (start + i) % count;
+            if (victim != self && (actor = workers[victim]->deque.steal()) != nullptr) {
+                return actor;
+            }
+        }
+        return nullptr;
+    }
+
+    void run(size_t self) {
+        currentWorker = workers[self].get();
+        currentScheduler = this;
+        mt19937 rng(self + 1);
+        int idleRounds = 0;
+        while (!stopping.load(memory_order_acquire)) {
+            Actor *actor = findWork(self, rng);
+            if (actor == nullptr) {
+                if (++idleRounds < 64) {
+                    this_thread::yield();
+                } else {
+                    this_thread::sleep_for(chrono::microseconds(50));
+                }
+                continue;
+            }
+            idleRounds = 0;
+            actor->run();
+        }
+    }
+
+public:
+    Scheduler(int workerCount) : externalPosted(0), stopping(false) {
+        for (int i = 0; i < workerCount; i++) {
+            workers.emplace_back(new Worker());
+        }
+        for (int i = 0; i < workerCount; i++) {
+            workers[i]->runner = thread(&Scheduler::run, this, i);
+        }
+    }
+
+    // Stops the workers. Call waitIdle() first to drain outstanding messages.
+    ~Scheduler() {
+        stopping.store(true, memory_order_release);
+        for (auto &worker : workers) {
+            worker->runner.join();
+        }
+    }
+
+    void schedule(Actor *actor) {
+        if (currentScheduler == this && currentWorker->deque.push(actor)) {
+            return;
+        }
+        lock_guard<mutex> lock(injectionMutex);
+        injected.push_back(actor);
+    }
+
+    void countPosted() {
+        if (currentScheduler == this) {
+            currentWorker->posted.fetch_add(1, memory_order_relaxed);
+        } else {
+            externalPosted.fetch_add(1, memory_order_relaxed);
+        }
+    }
+
+    // Called by Actor::run on a worker thread after each message.
+    void recordLatency(long long postedAt) {
+        currentWorker->latency.record(nowNanos() - postedAt);
+    }
+
+    // Called by Actor::run once it no longer touches the actor, so an idle scheduler never has a
+    // worker still inside an actor and actors may be destroyed after waitIdle().
+    void countHandled(int messages) {
+        currentWorker->handled.fetch_add(messages, memory_order_release);
+    }
+
+    // Waits until every message posted so far, and every message those caused, has been handled.
+    // Handled counts are read before posted counts: a message is counted as handled only after the
+    // messages it posted were counted, so equal sums mean nothing is in flight.
+    void waitIdle() {
+        while (true) {
+            long long handled = 0;
+            long long posted = 0;
+            for (auto &worker : workers) {
+                handled += worker->handled.load(memory_order_acquire);
+            }
+            for (auto &worker : workers) {
+                posted += worker->posted.load(memory_order_acquire);
+            }
+            posted += externalPosted.load(memory_order_acquire);
+            if (handled == posted) {
+                return;
+            }
+            this_thread::yield();
+        }
+    }
+
+    // Merged latency of all handled messages. Only meaningful while the scheduler is idle.
+    LatencyHistogram latency() {
+        LatencyHistogram merged;
+        for (auto &worker : workers) {
+            merged.merge(worker->latency);
+        }
+        return merged;
+    }
+};
+
+thread_local Scheduler::Worker *Scheduler::currentWorker = nullptr;
+thread_local Scheduler *Scheduler::currentScheduler = nullptr;
+
+void Actor::post(Message *message) {
+    message->postedAt = nowNanos();
+    scheduler->countPosted();
+    mailbox.push(message);
+    if (!scheduled.exchange(true)) {
+        scheduler->schedule(this);
+    }
+}
+
+int Actor::run() {
+    Scheduler *owner = scheduler; // The actor may be run elsewhere once it is released below
+    int handled = 0;
+    while (handled < BATCH_SIZE) {
+        Message *message = mailbox.pop();
+        if (message == nullptr) {
+            break;
+        }
+        receive(message);
+        owner->recordLatency(message->postedAt);
+        delete message;
+        handled++;
+    }
+    if (!mailbox.empty()) {
+        owner->schedule(this); // More work, but give other actors a turn first
+    } else {
+        // Clear the flag, then look again: a post that saw the flag still set has already pushed
+        // its message, so it is visible here and this worker reschedules the actor instead.
+        scheduled.store(false);
+        if (!mailbox.empty() && !scheduled.exchange(true)) {
+            owner->schedule(this);
+        }
+    }
+    owner->countHandled(handled);
+    return handled;
+}
+
+// Wraps one IBidder: notifications from its mailbox are delivered to the bidder in order.
+class BidderActor : public Actor {
+    IBidder *bidder;
+
+protected:
+    void receive(Message *message) override {
+        bidder->receiveBidNotification(message->bidder->getName(), message->bidAmount);
+    }
+
+public:
+    BidderActor(Scheduler *s, IBidder *b) : Actor(s), bidder(b) {}
+};
+
+// Concrete implementation of the auction mediator as an actor.
+// placeBid() only posts a PLACE_BID message to the mediator's own mailbox and returns, so a bidder
+// never runs other bidders' code on its stack. When the mediator actor handles the bid, it posts a
+// BID_NOTIFICATION to every other bidder's mailbox. Bidders must be added before bidding starts.
+class AuctionMediator : public IAuctionMediator, public Actor {
+    Scheduler *scheduler;
+    vector<IBidder *> bidders;                 // Collection of bidders participating in the auction
+    vector<unique_ptr<BidderActor>> actors;    // One actor per bidder, same order
+
+protected:
+    void receive(Message *message) override {
+        for (size_t i = 0; i < bidders.size(); i++) {
+            if (bidders[i] != message->bidder) { // Skip the bidder who placed the bid
+                Message *notification = new Message();
+                notification->kind = Message::BID_NOTIFICATION;
+                notification->bidder = message->bidder;
+                notification->bidAmount = message->bidAmount;
+                actors[i]->post(notification);
+            }
+        }
+    }
+
+public:
+    AuctionMediator(Scheduler *s) : Actor(s), scheduler(s) {}
+
+    void addBidder(IBidder *bidder) override {
+        bidders.push_back(bidder);
+        actors.emplace_back(new BidderActor(scheduler, bidder));
+    }
+
+    void placeBid(IBidder *bidder, int bidAmount) override {
+        Message *message = new Message();
+        message->kind = Message::PLACE_BID;
+        message->bidder = bidder;
+        message->bidAmount = bidAmount;
+        post(message);
+    }
+};
+
+// Counts the messages it receives, for checkBatchBoundary().
+class CountingActor : public Actor {
+protected:
+    void receive(Message *message) override {
+        received.fetch_add(1, memory_order_relaxed);
+    }
+
+public:
+    atomic<int> received{0};
+
+    CountingActor(Scheduler *s) : Actor(s) {}
+};
+
+// On each message, posts `burst` messages to the target. On a one-worker scheduler the target
+// cannot run until this returns, so its whole burst is waiting in the mailbox when it does.
+class BurstActor : public Actor {
+    Actor *target;
+    int burst;
+
+protected:
+    void receive(Message *message) override {
+        for (int i = 0; i < burst; i++) {
+            Message *posted = new Message();
+            posted->kind = Message::BID_NOTIFICATION;
+            posted->bidder = nullptr;
+            posted->bidAmount = i;
+            target->post(posted);
+        }
+    }
+
+public:
+    BurstActor(Scheduler *s, Actor *t, int b) : Actor(s), target(t), burst(b) {}
+};
+
+// Posts one message more than a batch to an actor and checks that all of them are delivered: the
+// last one is left for the next run, and the actor must be rescheduled for it.
+bool checkBatchBoundary(Scheduler *scheduler) {
+    const int MESSAGES = Actor::BATCH_SIZE + 1;
+    CountingActor target(scheduler);
+    BurstActor burst(scheduler, &target, MESSAGES);
+    Message *start = new Message();
+    start->kind = Message::BID_NOTIFICATION;
+    start->bidder = nullptr;
+    start->bidAmount = 0;
+    burst.post(start);
+    // Bounded wait: waitIdle() would never return if a message were stranded.
+    for (int wait = 0; wait < 1000 && target.received.load() < MESSAGES; wait++) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    int received = target.received.load();
+    cout << "batch boundary: " << received << " of " << MESSAGES << " messages delivered" << endl;
+    if (received != MESSAGES) {
+        return false;
+    }
+    scheduler->waitIdle();
+    return true;
+}
+
+// The classic synchronous broadcast, for comparison: notifications per second on one thread.
+double directNotificationsPerSecond(vector<unique_ptr<CountingBidder>> &bidders, int bids) {
+    vector<IBidder *> all;
+    for (auto &bidder : bidders) {
+        all.push_back(bidder.get());
+    }
+    long long notifications = 0;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < bids; i++) {
+        IBidder *from = all[i % all.size()];
+        for (auto notifyBidder : all) {
+            if (notifyBidder != from) {
+                notifyBidder->receiveBidNotification(from->getName(), 100 + i);
+                notifications++;
+            }
+        }
+    }
+    return notifications / chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Bids are placed one at a time and each broadcast is drained before the next, so the latency
+// reported is the time a notification waits while the mediator fans one bid out to every bidder.
+void benchmark(int workerCount, int bidderCount, int bids) {
+    Scheduler scheduler(workerCount);
+    AuctionMediator mediator(&scheduler);
+    vector<unique_ptr<CountingBidder>> bidders;
+    for (int b = 0; b < bidderCount; b++) {
+        bidders.emplace_back(new CountingBidder("bidder" + to_string(b), &mediator));
+    }
+
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < bids; i++) {
+        bidders[(i * 7919) % bidderCount]->placeBid(100 + i);
+        scheduler.waitIdle();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    LatencyHistogram latency = scheduler.latency();
+    long long messages = latency.total();
+    cout << "actors, " << workerCount << " workers, " << bidderCount << " bidders: " << messages / seconds / 1e6
+         << " M messages/s, latency p50 " << latency.percentile(0.5) / 1000 << " us, p99 "
+         << latency.percentile(0.99) / 1000 << " us, p99.9 " << latency.percentile(0.999) / 1000 << " us, max "
+         << latency.percentile(1.0) / 1000 << " us" << endl;
+    cout << "direct calls, 1 thread:          " << directNotificationsPerSecond(bidders, bids / 10) / 1e6
+         << " M notifications/s" << endl;
+}
+
+// Main function to demonstrate actor bidders
+int main() {
+    Scheduler *scheduler = new Scheduler(1); // One worker keeps the demo output in order
+    AuctionMediator *auctionMediator = new AuctionMediator(scheduler);
+
+    IBidder *bidder1 = new Bidder("samyak", auctionMediator);
+    IBidder *bidder2 = new Bidder("shreya", auctionMediator);
+    IBidder *bidder3 = new Bidder("aishik", auctionMediator);
+
+    bidder1->placeBid(100);
+    scheduler->waitIdle();
+    cout << "--------------" << endl;
+    bidder2->placeBid(200);
+    scheduler->waitIdle();
+    cout << "--------------" << endl;
+    bidder3->placeBid(300);
+    scheduler->waitIdle();
+
+    cout << "--------------" << endl;
+    if (!checkBatchBoundary(scheduler)) {
+        cerr << "a message was left in a mailbox after a full batch" << endl;
+        return 1;
+    }
+
+    cout << "--------------" << endl;
+    unsigned cores = max(1u, thread::hardware_concurrency());
+    benchmark((int)cores, 100000, 100);
+
+    delete scheduler;
+    delete auctionMediator;
+    delete bidder1;
+    delete bidder2;
+    delete bidder3;
+
+    return 0;
+}
@@ -0,0 +1,505 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Mediator Design Pattern with Bid Replay:
+// Changes to the AuctionMediator are hard to compare without reproducible load. This variant adds
+// a BidLoadGenerator that synthesizes a deterministic bid stream from a LoadProfile (bidder count,
+// how bids are spread over bidders, how bid amounts grow, and how bursty arrivals are), a compact
+// binary trace format to record such a stream, and a ReplayDriver that feeds a trace through any
+// IAuctionMediator either as fast as possible or at the recorded timing and reports throughput and
+// latency percentiles. Two mediator builds replaying the same trace see identical input.
+//
+// Usage:
+//   ./a.out                                  demo, then record and replay a sample trace
+//   ./a.out record <file> [bidders] [bids] [bids/s] [seed]
+//   ./a.out replay <file> [fast|timed]
+
+// Abstract interface for a bidder in the auction
+class IBidder {
+public:
+    virtual void placeBid(int bidAmount) = 0;                // Places a bid
+    virtual void receiveBidNotification(string bidderName, int bidAmount) = 0; // Receives notification of other bids
+    virtual string getName() = 0;                           // Returns the name of the bidder
+    virtual ~IBidder() = default;
+};
+
+// Abstract interface for the mediator
+class IAuctionMediator {
+public:
+    virtual void addBidder(IBidder *bidder) = 0;            // Adds a bidder to the auction
+    virtual void placeBid(IBidder *bidder, int bidAmount) = 0; // Handles the bid placement
+    virtual ~IAuctionMediator() = default;
+};
+
+// Concrete implementation of a bidder
+class Bidder : public IBidder {
+    string name;                   // Name of the bidder
+    IAuctionMediator *auctionMediator; // Reference to the mediator
+
+public:
+    Bidder(string nm, IAuctionMediator *am) : name(nm), auctionMediator(am) {
+        auctionMediator->addBidder(this); // Register bidder with the mediator
+    }
+
+    void placeBid(int bidAmount) override {
+        cout << name << " placed a bid of " << bidAmount << endl;
+        auctionMediator->placeBid(this, bidAmount);
+    }
+
+    void receiveBidNotification(string bidderName, int bidAmount) override {
+        cout << name << " received notification that " << bidderName << " placed a bid of " << bidAmount << endl;
+    }
+
+    string getName() override {
+        return name;
+    }
+};
+
+// A bidder that only counts its notifications, used for replay.
+class CountingBidder : public IBidder {
+    string name;
+    IAuctionMediator *auctionMediator;
+
+public:
+    long long notifications = 0;
+
+    CountingBidder(string nm, IAuctionMediator *am) : name(nm), auctionMediator(am) {
+        auctionMediator->addBidder(this);
+    }
+
+    void placeBid(int bidAmount) override {
+        auctionMediator->placeBid(this, bidAmount);
+    }
+
+    void receiveBidNotification(string bidderName, int bidAmount) override {
+        notifications++;
+    }
+
+    string getName() override {
+        return name;
+    }
+};
+
+// Concrete implementation of the auction mediator, unchanged from the classic version
+class AuctionMediator : public IAuctionMediator {
+    set<IBidder *> bidders; // Collection of bidders participating in the auction
+
+public:
+    void addBidder(IBidder *bidder) override {
+        bidders.insert(bidder);
+    }
+
+    void placeBid(IBidder *bidder, int bidAmount) override {
+        for (auto notifyBidder : bidders) {
+            if (notifyBidder != bidder) { // Skip the bidder who placed the bid
+                notifyBidder->receiveBidNotification(bidder->getName(), bidAmount);
+            }
+        }
+    }
+};
+
+// One bid of a trace.
+struct BidEvent {
+    uint64_t atNanos;   // Time since the start of the trace
+    uint32_t bidder;    // Index of the bidder, below the trace's bidder count
+    uint32_t amount;
+};
+
+// Shape of a synthetic bid stream. Arrivals follow a Poisson process whose rate switches between
+// a calm and a burst state (a two-state Markov-modulated process); bids pick a bidder uniformly or
+// by a Zipf law, and raise the running price by a random increment, some of them falling short.
+struct LoadProfile {
+    enum BidderDistribution { UNIFORM, ZIPF };
+
+    uint32_t bidderCount = 1000;
+    uint64_t bidCount = 100000;
+    double bidsPerSecond = 100000;     // Mean arrival rate in the calm state
+    BidderDistribution distribution = ZIPF;
+    double zipfExponent = 1.1;         // Higher means a few bidders place most bids
+    double burstRateFactor = 10;       // Arrival rate multiplier while bursting
+    double burstProbability = 0.001;   // Chance per calm bid of entering a burst
+    double meanBurstLength = 500;      // Mean number of bids in a burst
+    uint32_t startingPrice = 100;
+    uint32_t meanIncrement = 5;
+    double staleBidFraction = 0.3;     // Bids placed below the running price
+    uint64_t seed = 1;
+};
+
+// BidLoadGenerator class
+// Produces the same events for the same profile on every run. It draws from mt19937_64, whose
+// sequence is fixed by the standard, with its own inverse-transform sampling instead of the std
+// distributions, whose output differs between standard libraries.
+class BidLoadGenerator {
+    LoadProfile profile;
+    mt19937_64 rng;
+    vector<double> zipfCdf;
+
+    double uniform() {
+        return (rng() >> 11) * (1.0 / 9007199254740992.0); // 53 random bits in [0, 1)
+    }
+
+    double exponential(double mean) {
+        return -log(1.0 - uniform()) * mean;
+    }
+
+    uint32_t pickBidder() {
+        if (profile.distribution == LoadProfile::UNIFORM) {
+            return (uint32_t)(uniform() * profile.bidderCount);
+        }
+        return (uint32_t)(lower_bound(zipfCdf.begin(), zipfCdf.end(), uniform()) - zipfCdf.begin());
+    }
+
+public:
+    BidLoadGenerator(const LoadProfile &p) : profile(p), rng(p.seed) {
+        if (profile.bidderCount < 2 || profile.bidsPerSecond <= 0) {
+            throw invalid_argument("BidLoadGenerator: need at least 2 bidders and a positive rate");
+        }
+        if (profile.distribution == LoadProfile::ZIPF) {
+            double sum = 0;
+            for (uint32_t rank = 1; rank <= profile.bidderCount; rank++) {
+                sum += 1.0 / pow(rank, profile.zipfExponent);
+                zipfCdf.push_back(sum);
+            }
+            for (double &value : zipfCdf) {
+                value /= sum;
+            }
+            zipfCdf.back() = 1.0;
+        }
+    }
+
+    vector<BidEvent> generate() {
+        vector<BidEvent> events;
+        events.reserve(profile.bidCount);
+        double nanos = 0;
+        double calmGap = 1e9 / profile.bidsPerSecond;
+        uint64_t burstLeft = 0;
+        uint32_t price = profile.startingPrice;
+        for (uint64_t i = 0; i < profile.bidCount; i++) {
+            if (burstLeft == 0 && uniform() < profile.burstProbability) {
+                burstLeft = 1 + (uint64_t)exponential(profile.meanBurstLength);
+            }
+            double gap = burstLeft > 0 ? calmGap / profile.burstRateFactor : calmGap;
+            if (burstLeft > 0) {
+                burstLeft--;
+            }
+            nanos += exponential(gap);
+
+            uint32_t amount;
+            if (uniform() < profile.staleBidFraction) {
+                uint32_t shortfall = 1 + (uint32_t)(uniform() * profile.meanIncrement * 4);
+                amount = price > shortfall ? price - shortfall : 1;
+            } else {
+                price += 1 + (uint32_t)exponential(profile.meanIncrement);
+                amount = price;
+            }
+            events.push_back({(uint64_t)nanos, pickBidder(), amount});
+        }
+        return events;
+    }
+};
+
+// Binary trace format, little-endian:
+//   header: "BIDT", u32 version, u32 bidder count, u64 bid count, u64 seed
+//   events: per bid, three unsigned LEB128 varints: time delta since the previous bid in ns,
+//           bidder index, and bid amount
+// A typical bid takes 5 to 7 bytes instead of 16.
+struct BidTrace {
+    static const uint32_t VERSION = 1;
+
+    uint32_t bidderCount = 0;
+    uint64_t seed = 0;
+    vector<BidEvent> events;
+
+    static void putVarint(string &out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back((char)(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back((char)value);
+    }
+
+    static uint64_t getVarint(const string &in, size_t &pos) {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos >= in.size()) {
+                throw runtime_error("BidTrace: truncated event");
+            }
+            uint8_t byte = in[pos++];
+            value |= (uint64_t)(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw runtime_error("BidTrace: malformed varint");
+    }
+
+    template <typename T>
+    static void putFixed(string &out, T value) {
+        for (size_t i = 0; i < sizeof(T); i++) {
+            out.push_back((char)(value >> (8 * i)));
+        }
+    }
+
+    template <typename T>
+    static T getFixed(const string &in, size_t &pos) {
+        if (pos + sizeof(T) > in.size()) {
+            throw runtime_error("BidTrace: truncated header");
+        }
+        T value = 0;
+        for (size_t i = 0; i < sizeof(T); i++) {
+            value |= (T)(uint8_t)in[pos++] << (8 * i);
+        }
+        return value;
+    }
+
+    string encode() const {
+        string out = "BIDT";
+        putFixed<uint32_t>(out, VERSION);
+        putFixed<uint32_t>(out, bidderCount);
+        putFixed<uint64_t>(out, events.size());
+        putFixed<uint64_t>(out, seed);
+        uint64_t previous = 0;
+        for (const BidEvent &event : events) {
+            putVarint(out, event.atNanos - previous);
+            putVarint(out, event.bidder);
+            putVarint(out, event.amount);
+            previous = event.atNanos;
+        }
+        return out;
+    }
+
+    static BidTrace decode(const string &in) {
+        if (in.compare(0, 4, "BIDT") != 0) {
+            throw runtime_error("BidTrace: not a bid trace");
+        }
+        size_t pos = 4;
+        if (getFixed<uint32_t>(in, pos) != VERSION) {
+            throw runtime_error("BidTrace: unsupported version");
+        }
+        BidTrace trace;
+        trace.bidderCount = getFixed<uint32_t>(in, pos);
+        uint64_t count = getFixed<uint64_t>(in, pos);
+        trace.seed = getFixed<uint64_t>(in, pos);
+        trace.events.reserve(count);
+        uint64_t at = 0;
+        for (uint64_t i = 0; i < count; i++) {
+            at += getVarint(in, pos);
+            uint64_t bidder = getVarint(in, pos);
+            uint64_t amount = getVarint(in, pos);
+            if (bidder >= trace.bidderCount || amount > UINT32_MAX) {
+                throw runtime_error("BidTrace: event out of range");
+            }
+            trace.events.push_back({at, (uint32_t)bidder, (uint32_t)amount});
+        }
+        return trace;
+    }
+
+    void save(const string &path) const {
+        ofstream file(path, ios::binary);
+        string bytes = encode();
+        if (!file.write(bytes.data(), bytes.size())) {
+            throw runtime_error("BidTrace: cannot write " + path);
+        }
+    }
+
+    static BidTrace load(const string &path) {
+        ifstream file(path, ios::binary);
+        if (!file) {
+            throw runtime_error("BidTrace: cannot open " + path);
+        }
+        return decode(string(istreambuf_iterator<char>(file), istreambuf_iterator<char>()));
+    }
+};
+
+// Result of one replay. Latencies are sorted, in nanoseconds.
+struct ReplayReport {
+    uint64_t bids = 0;
+    double seconds = 0;
+    vector<uint64_t> latencies;
+
+    uint64_t percentile(double quantile) const {
+        if (latencies.empty()) {
+            return 0;
+        }
+        size_t index = min(latencies.size() - 1, (size_t)ceil(quantile * latencies.size()) - (quantile > 0 ? 1 : 0));
+        return latencies[index];
+    }
+
+    void print(ostream &out, const string &label) const {
+        out << label << ": " << bids << " bids in " << seconds * 1000 << " ms, " << bids / seconds / 1e3
+            << " k bids/s, latency us p50 " << percentile(0.5) / 1e3 << " p99 " << percentile(0.99) / 1e3
+            << " p99.9 " << percentile(0.999) / 1e3 << " max " << percentile(1.0) / 1e3 << endl;
+    }
+};
+
+// ReplayDriver class
+// Feeds a trace through a mediator whose bidders were created for it. In FAST mode bids are placed
+// back to back and latency is the time spent in placeBid. In RECORDED_TIMING mode each bid is
+// placed at its recorded offset from the start, and latency is measured from that intended time,
+// so a mediator that falls behind is charged for the bids queued up behind a slow one.
+class ReplayDriver {
+public:
+    enum Mode { FAST, RECORDED_TIMING };
+
+    static ReplayReport replay(const BidTrace &trace, vector<IBidder *> &bidders, Mode mode) {
+        if (bidders.size() < trace.bidderCount) {
+            throw invalid_argument("ReplayDriver: trace needs " + to_string(trace.bidderCount) + " bidders");
+        }
+        ReplayReport report;
+        report.bids = trace.events.size();
+        report.latencies.reserve(trace.events.size());
+        auto start = chrono::steady_clock::now();
+        for (const BidEvent &event : trace.events) {
+            auto intended = start + chrono::nanoseconds(event.atNanos);
+            if (mode == RECORDED_TIMING) {
+                auto now = chrono::steady_clock::now();
+                if (intended - now > chrono::microseconds(200)) {
+                    this_thread::sleep_for(intended - now - chrono::microseconds(100));
+                }
+                while (chrono::steady_clock::now() < intended) {
+                    // Spin for the last stretch; sleeping is too coarse
+                }
+            }
+            auto begin = chrono::steady_clock::now();
+            bidders[event.bidder]->placeBid((int)event.amount);
+            auto end = chrono::steady_clock::now();
+            auto from = mode == RECORDED_TIMING ? intended : begin;
+            report.latencies.push_back(chrono::duration_cast<chrono::nanoseconds>(end - from).count());
+        }
+        report.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        sort(report.latencies.begin(), report.latencies.end());
+        return report;
+    }
+};
+
+// Replays a trace against a fresh classic AuctionMediator.
+ReplayReport replayOnAuctionMediator(const BidTrace &trace, ReplayDriver::Mode mode) {
+    AuctionMediator mediator;
+    vector<unique_ptr<CountingBidder>> owned;
+    vector<IBidder *> bidders;
+    for (uint32_t b = 0; b < trace.bidderCount; b++) {
+        owned.emplace_back(new CountingBidder("bidder" + to_string(b), &mediator));
+        bidders.push_back(owned.back().get());
+    }
+    return ReplayDriver::replay(trace, bidders, mode);
+}
+
+BidTrace record(const LoadProfile &profile) {
+    BidTrace trace;
+    trace.bidderCount = profile.bidderCount;
+    trace.seed = profile.seed;
+    trace.events = BidLoadGenerator(profile).generate();
+    return trace;
+}
+
+// Parses a whole command-line argument as an unsigned number no larger than `limit`. stoull alone
+// would accept "-1" (wrapping it) and trailing garbage such as "10x".
+uint64_t parseCount(const string &text, uint64_t limit) {
+    size_t used = 0;
+    uint64_t value = text.empty() || text[0] == '-' ? limit + 1 : stoull(text, &used);
+    if (used != text.size() || value > limit) {
+        throw invalid_argument("not a number up to " + to_string(limit) + ": " + text);
+    }
+    return value;
+}
+
+double parseRate(const string &text) {
+    size_t used = 0;
+    double value = stod(text, &used);
+    if (used != text.size() || !(value > 0)) {
+        throw invalid_argument("not a positive rate: " + text);
+    }
+    return value;
+}
+
+int usage(const char *program, const string &problem) {
+    cerr << program << ": " << problem << endl
+         << "usage: " << program << " record <file> [bidders [bids [bids-per-second [seed]]]]" << endl
+         << "       " << program << " replay <file> [timed]" << endl
+         << "       " << program << "    (demo and sample replay)" << endl;
+    return 2;
+}
+
+// Main function to demonstrate bid replay
+int main(int argc, char **argv) {
+    if (argc >= 3 && string(argv[1]) == "record") {
+        LoadProfile profile;
+        try {
+            if (argc > 3) profile.bidderCount = parseCount(argv[3], UINT32_MAX);
+            if (argc > 4) profile.bidCount = parseCount(argv[4], UINT64_MAX - 1);
+            if (argc > 5) profile.bidsPerSecond = parseRate(argv[5]);
+            if (argc > 6) profile.seed = parseCount(argv[6], UINT64_MAX - 1);
+        } catch (const logic_error &e) { // invalid_argument and out_of_range from the parsers
+            return usage(argv[0], e.what());
+        }
+        try {
+            BidTrace trace = record(profile);
+            trace.save(argv[2]);
+            cout << "recorded " << trace.events.size() << " bids for " << trace.bidderCount << " bidders to " << argv[2] << endl;
+        } catch (const exception &e) {
+            cerr << argv[0] << ": " << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+    if (argc >= 3 && string(argv[1]) == "replay") {
+        bool timed = argc > 3 && string(argv[3]) == "timed";
+        if (argc > 4 || (argc > 3 && !timed)) {
+            return usage(argv[0], "unexpected argument " + string(argv[argc > 4 ? 4 : 3]));
+        }
+        try {
+            BidTrace trace = BidTrace::load(argv[2]);
+            replayOnAuctionMediator(trace, timed ? ReplayDriver::RECORDED_TIMING : ReplayDriver::FAST)
+                .print(cout, timed ? "recorded timing" : "fast");
+        } catch (const exception &e) {
+            cerr << argv[0] << ": " << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+    if (argc > 1) {
+        return usage(argv[0], "unknown command " + string(argv[1]));
+    }
+
+    IAuctionMediator *auctionMediator = new AuctionMediator();
+
+    IBidder *bidder1 = new Bidder("samyak", auctionMediator);
+    IBidder *bidder2 = new Bidder("shreya", auctionMediator);
+    IBidder *bidder3 = new Bidder("aishik", auctionMediator);
+
+    bidder1->placeBid(100);
+    cout << "--------------" << endl;
+    bidder2->placeBid(200);
+    cout << "--------------" << endl;
+    bidder3->placeBid(300);
+    cout << "--------------" << endl;
+
+    // Record a bursty sample trace, check it survives a round trip, then replay it both ways
+    LoadProfile profile;
+    profile.bidderCount = 200;
+    profile.bidCount = 50000;
+    profile.bidsPerSecond = 50000;
+    BidTrace trace = record(profile);
+    string path = (filesystem::temp_directory_path() / "bid-replay-sample.trace").string();
+    trace.save(path);
+    BidTrace loaded = BidTrace::load(path);
+    bool identical = loaded.events.size() == trace.events.size() &&
+                     equal(loaded.events.begin(), loaded.events.end(), trace.events.begin(),
+                           [](const BidEvent &a, const BidEvent &b) {
+                               return a.atNanos == b.atNanos && a.bidder == b.bidder && a.amount == b.amount;
+                           });
+    cout << "trace: " << trace.events.size() << " bids over " << trace.events.back().atNanos / 1e6 << " ms, "
+         << trace.encode().size() << " bytes (" << (double)trace.encode().size() / trace.events.size()
+         << " bytes/bid), round trip " << (identical ? "identical" : "MISMATCH") << endl;
+    remove(path.c_str());
+
+    replayOnAuctionMediator(loaded, ReplayDriver::FAST).print(cout, "fast");
+    replayOnAuctionMediator(loaded, ReplayDriver::RECORDED_TIMING).print(cout, "recorded timing");
+
+    delete bidder1;
+    delete bidder2;
+    delete bidder3;
+    delete auctionMediator;
+
+    return 0;
+}
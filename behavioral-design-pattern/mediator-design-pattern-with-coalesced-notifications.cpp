@@ -0,0 +1,306 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Mediator Design Pattern with Coalesced Notifications:
+// In the classic AuctionMediator every bid triggers N-1 virtual receiveBidNotification() calls,
+// each with a copy of the bidder's name, so a round in which every bidder bids once costs O(N^2).
+// This variant adds a coalesced delivery mode. The mediator only records each bid, and at the end
+// of every tick it sends each bidder one summary: the best bid of the auction, the number of bids
+// in the tick and the leading bidder as an interned integer id instead of a name string.
+
+// Summary of one tick, delivered once per bidder in coalesced mode.
+struct BidSummary {
+    int bestAmount;      // Best bid so far in the auction
+    int bestBidderId;    // Interned id of the bidder holding it, -1 if nobody has bid
+    int bidsInTick;      // Number of bids received during the tick
+};
+
+// Abstract interface for a bidder in the auction
+class IBidder {
+public:
+    virtual void placeBid(int bidAmount) = 0;                // Places a bid
+    virtual void receiveBidNotification(string bidderName, int bidAmount) = 0; // Receives notification of other bids
+    virtual void receiveBidSummary(const BidSummary &summary) = 0; // Receives the summary of a tick
+    virtual string getName() = 0;                           // Returns the name of the bidder
+    virtual ~IBidder() = default;
+};
+
+// Abstract interface for the mediator
+class IAuctionMediator {
+public:
+    virtual int addBidder(IBidder *bidder) = 0;             // Adds a bidder and returns its interned id
+    virtual void placeBid(IBidder *bidder, int bidAmount) = 0; // Handles the bid placement
+    virtual const string &nameOf(int bidderId) = 0;         // Resolves an interned id back to a name
+    virtual ~IAuctionMediator() = default;
+};
+
+// Concrete implementation of a bidder
+class Bidder : public IBidder {
+    string name;                   // Name of the bidder
+    IAuctionMediator *auctionMediator; // Reference to the mediator
+    int id;                        // Interned id assigned by the mediator
+
+public:
+    Bidder(string nm, IAuctionMediator *am) : name(nm), auctionMediator(am) {
+        id = auctionMediator->addBidder(this);
+    }
+
+    void placeBid(int bidAmount) override {
+        cout << name << " placed a bid of " << bidAmount << endl;
+        auctionMediator->placeBid(this, bidAmount);
+    }
+
+    void receiveBidNotification(string bidderName, int bidAmount) override {
+        cout << name << " received notification that " << bidderName << " placed a bid of " << bidAmount << endl;
+    }
+
+    // The name is only looked up here, for printing; the summary itself carries just the id.
+    void receiveBidSummary(const BidSummary &summary) override {
+        if (summary.bestBidderId == id) {
+            cout << name << " is leading with " << summary.bestAmount << " (" << summary.bidsInTick << " bids this tick)" << endl;
+        } else {
+            cout << name << " sees best bid " << summary.bestAmount << " by " << auctionMediator->nameOf(summary.bestBidderId)
+                 << " (" << summary.bidsInTick << " bids this tick)" << endl;
+        }
+    }
+
+    string getName() override {
+        return name;
+    }
+};
+
+// A bidder that only counts what it receives, used by the benchmark.
+class CountingBidder : public IBidder {
+    string name;
+    IAuctionMediator *auctionMediator;
+
+public:
+    long long notifications = 0;
+    int lastBest = 0;
+
+    CountingBidder(string nm, IAuctionMediator *am) : name(nm), auctionMediator(am) {
+        auctionMediator->addBidder(this);
+    }
+
+    void placeBid(int bidAmount) override {
+        auctionMediator->placeBid(this, bidAmount);
+    }
+
+    void receiveBidNotification(string bidderName, int bidAmount) override {
+        notifications++;
+        lastBest = max(lastBest, bidAmount);
+    }
+
+    void receiveBidSummary(const BidSummary &summary) override {
+        notifications++;
+        lastBest = summary.bestAmount;
+    }
+
+    string getName() override {
+        return name;
+    }
+};
+
+// Concrete implementation of the auction mediator with two delivery modes.
+// IMMEDIATE behaves like the classic mediator. COALESCED records bids and delivers one summary per
+// bidder when a tick ends. A timer thread closes a tick every tick interval, whether or not more
+// bids arrive, and flush() closes it early (for example when the auction ends). Bidders may be
+// added while the timer runs. Summaries are delivered on the timer thread, or on the caller of
+// flush(), with the mediator locked; the lock is recursive, so a bidder may still bid, look up a
+// name or add a bidder from receiveBidSummary(), and such a bid counts towards the next tick.
+class AuctionMediator : public IAuctionMediator {
+public:
+    enum DeliveryMode { IMMEDIATE, COALESCED };
+
+private:
+    vector<IBidder *> bidders;             // Bidders, indexed by interned id
+    vector<string> names;                  // Interned names, indexed by id
+    unordered_map<IBidder *, int> ids;
+    DeliveryMode mode;
+    chrono::steady_clock::duration tickInterval;
+    chrono::steady_clock::time_point tickEnd;
+    recursive_mutex lock;                  // Guards the bidders and the tick state
+    condition_variable_any stopTimer;
+    bool stopping;
+    thread timer;                          // Only runs in coalesced mode
+
+    int bestAmount;
+    int bestBidderId;
+    int bidsInTick;
+    long long ticks;                       // Ticks that ended with a summary
+    long long notificationCalls;
+
+public:
+    AuctionMediator(DeliveryMode m = IMMEDIATE, chrono::steady_clock::duration interval = chrono::milliseconds(100))
+        : mode(m), tickInterval(interval), tickEnd(chrono::steady_clock::now() + interval),
+          stopping(false), bestAmount(0), bestBidderId(-1), bidsInTick(0), ticks(0), notificationCalls(0) {
+        if (mode == COALESCED) {
+            timer = thread([this]() { timerLoop(); });
+        }
+    }
+
+    // Stops the timer. Bids still pending are not delivered; call flush() first to send them.
+    ~AuctionMediator() {
+        if (timer.joinable()) {
+            {
+                lock_guard<recursive_mutex> guard(lock);
+                stopping = true;
+            }
+            stopTimer.notify_one();
+            timer.join();
+        }
+    }
+
+    int addBidder(IBidder *bidder) override {
+        lock_guard<recursive_mutex> guard(lock);
+        int id = bidders.size();
+        bidders.push_back(bidder);
+        names.push_back(bidder->getName());
+        ids[bidder] = id;
+        return id;
+    }
+
+    // The reference stays valid only until the next addBidder().
+    const string &nameOf(int bidderId) override {
+        lock_guard<recursive_mutex> guard(lock);
+        return names.at(bidderId);
+    }
+
+    void placeBid(IBidder *bidder, int bidAmount) override {
+        lock_guard<recursive_mutex> guard(lock);
+        int id = ids.at(bidder);
+        if (mode == IMMEDIATE) {
+            for (auto notifyBidder : bidders) {
+                if (notifyBidder != bidder) { // Skip the bidder who placed the bid
+                    notifyBidder->receiveBidNotification(names[id], bidAmount);
+                    notificationCalls++;
+                }
+            }
+            return;
+        }
+
+        if (bidAmount > bestAmount) {
+            bestAmount = bidAmount;
+            bestBidderId = id;
+        }
+        bidsInTick++;
+    }
+
+    // Ends the current tick now instead of at the next timer deadline.
+    void flush() {
+        lock_guard<recursive_mutex> guard(lock);
+        closeTick();
+    }
+
+    long long getNotificationCalls() {
+        lock_guard<recursive_mutex> guard(lock);
+        return notificationCalls;
+    }
+
+    long long getTicks() {
+        lock_guard<recursive_mutex> guard(lock);
+        return ticks;
+    }
+
+private:
+    // Sleeps until the end of the current tick and closes it, until the mediator is destroyed.
+    void timerLoop() {
+        unique_lock<recursive_mutex> guard(lock);
+        while (!stopping) {
+            // condition_variable_any reads the deadline after releasing the lock, so it gets a copy
+            chrono::steady_clock::time_point deadline = tickEnd;
+            stopTimer.wait_until(guard, deadline);
+            if (!stopping && chrono::steady_clock::now() >= tickEnd) {
+                closeTick();
+            }
+        }
+    }
+
+    // Starts the next tick, sending one summary to every bidder if any bid arrived during this one.
+    // The caller holds the lock. The tick is reset before delivery and only the bidders present
+    // when it ended are notified, so bidders may bid or register from receiveBidSummary().
+    void closeTick() {
+        tickEnd = chrono::steady_clock::now() + tickInterval;
+        if (bidsInTick == 0) {
+            return;
+        }
+        BidSummary summary = {bestAmount, bestBidderId, bidsInTick};
+        bidsInTick = 0;
+        ticks++;
+        size_t count = bidders.size();
+        for (size_t i = 0; i < count; i++) {
+            bidders[i]->receiveBidSummary(summary);
+            notificationCalls++;
+        }
+    }
+};
+
+// Every bidder bids `rounds` times as fast as it can. Coalesced mode's timer ends a tick every
+// `tickInterval`, and the last tick is flushed when the bidding stops. Immediate mode costs
+// bidders - 1 calls per bid, so it runs fewer rounds; the two are compared per bid. Coalesced mode
+// should run for many tick intervals, so that the result reflects ticks closed by the timer under
+// sustained load rather than a single flush.
+void benchmark(int bidderCount, int immediateRounds, int coalescedRounds, chrono::steady_clock::duration tickInterval) {
+    double callsPerBid[2];
+    double cpuPerBid[2];
+    for (auto mode : {AuctionMediator::IMMEDIATE, AuctionMediator::COALESCED}) {
+        AuctionMediator mediator(mode, tickInterval);
+        vector<unique_ptr<CountingBidder>> bidders;
+        for (int b = 0; b < bidderCount; b++) {
+            bidders.emplace_back(new CountingBidder("bidder" + to_string(b), &mediator));
+        }
+        int rounds = mode == AuctionMediator::IMMEDIATE ? immediateRounds : coalescedRounds;
+        mt19937 rng(1);
+        long long bids = 0;
+        auto cpuStart = clock();
+        auto start = chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            for (auto &bidder : bidders) {
+                bidder->placeBid(100 + (int)(rng() % 100000));
+                bids++;
+            }
+        }
+        mediator.flush();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        double cpuSeconds = (double)(clock() - cpuStart) / CLOCKS_PER_SEC;
+        long long calls = mediator.getNotificationCalls();
+        cout << (mode == AuctionMediator::IMMEDIATE ? "immediate: " : "coalesced: ") << bidderCount << " bidders, "
+             << bids << " bids, " << calls << " notification calls, " << seconds * 1000 << " ms wall, "
+             << cpuSeconds * 1000 << " ms CPU" << endl;
+        if (mode == AuctionMediator::COALESCED) {
+            long long ticks = max(mediator.getTicks(), 1LL);
+            cout << "           " << mediator.getTicks() << " ticks, " << (double)bids / ticks << " bids and "
+                 << (double)calls / ticks << " notification calls per tick" << endl;
+        }
+        callsPerBid[mode] = (double)calls / bids;
+        cpuPerBid[mode] = cpuSeconds / bids;
+    }
+    cout << "per bid: " << callsPerBid[0] / callsPerBid[1] << "x fewer notification calls, "
+         << cpuPerBid[0] / max(cpuPerBid[1], 1e-12) << "x less CPU" << endl;
+}
+
+// Main function to demonstrate coalesced notifications
+int main() {
+    AuctionMediator *auctionMediator = new AuctionMediator(AuctionMediator::COALESCED, chrono::milliseconds(50));
+
+    IBidder *bidder1 = new Bidder("samyak", auctionMediator);
+    IBidder *bidder2 = new Bidder("shreya", auctionMediator);
+    IBidder *bidder3 = new Bidder("aishik", auctionMediator);
+
+    // Three bids in one tick produce a single summary per bidder, sent by the timer when the tick ends
+    bidder1->placeBid(100);
+    bidder2->placeBid(200);
+    bidder3->placeBid(300);
+    cout << "--------------" << endl;
+    this_thread::sleep_for(chrono::milliseconds(100));
+
+    cout << "--------------" << endl;
+    benchmark(10000, 1, 200, chrono::milliseconds(1));
+
+    delete auctionMediator; // Stops the timer before the bidders go away
+    delete bidder1;
+    delete bidder2;
+    delete bidder3;
+
+    return 0;
+}
@@ -0,0 +1,335 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Mediator Design Pattern with a Dense Bidder Registry:
+// The classic AuctionMediator keeps its bidders in a set<IBidder *>, a red-black tree ordered by
+// pointer: registering is O(log n) with an allocation per node, and every broadcast chases tree
+// pointers scattered over the heap. This variant replaces the set with a BidderRegistry that hands
+// out dense integer handles. Handles index a contiguous slot array whose free slots form a free
+// list, and live bidders are also packed into a dense array, so register, unregister and lookup
+// are O(1) and a broadcast is a linear scan over contiguous memory.
+
+// A handle packs a slot index (low 32 bits) with the generation of that slot (high 32 bits), so a
+// handle kept after its bidder left does not match the next bidder given the same slot.
+typedef uint64_t BidderHandle;
+
+// Abstract interface for a bidder in the auction
+class IBidder {
+public:
+    virtual void placeBid(int bidAmount) = 0;                // Places a bid
+    virtual void receiveBidNotification(string bidderName, int bidAmount) = 0; // Receives notification of other bids
+    virtual string getName() = 0;                           // Returns the name of the bidder
+    virtual ~IBidder() = default;
+};
+
+// Abstract interface for the mediator
+class IAuctionMediator {
+public:
+    virtual BidderHandle addBidder(IBidder *bidder) = 0;    // Adds a bidder and returns its handle
+    virtual void removeBidder(BidderHandle handle) = 0;     // Removes a bidder from the auction
+    virtual bool tryRemoveBidder(BidderHandle handle) noexcept = 0; // Same, false for an unknown handle
+    virtual void placeBid(BidderHandle handle, int bidAmount) = 0; // Handles the bid placement
+    virtual ~IAuctionMediator() = default;
+};
+
+// Concrete implementation of a bidder
+class Bidder : public IBidder {
+    string name;                   // Name of the bidder
+    IAuctionMediator *auctionMediator; // Reference to the mediator
+    BidderHandle handle;           // Handle assigned by the mediator
+
+public:
+    Bidder(string nm, IAuctionMediator *am) : name(nm), auctionMediator(am) {
+        handle = auctionMediator->addBidder(this); // Register bidder with the mediator
+    }
+
+    ~Bidder() {
+        auctionMediator->tryRemoveBidder(handle); // Destructors must not throw
+    }
+
+    void placeBid(int bidAmount) override {
+        cout << name << " placed a bid of " << bidAmount << endl;
+        auctionMediator->placeBid(handle, bidAmount);
+    }
+
+    void receiveBidNotification(string bidderName, int bidAmount) override {
+        cout << name << " received notification that " << bidderName << " placed a bid of " << bidAmount << endl;
+    }
+
+    string getName() override {
+        return name;
+    }
+
+    BidderHandle getHandle() {
+        return handle;
+    }
+};
+
+// A bidder that only counts its notifications, used by the benchmark.
+class CountingBidder : public IBidder {
+    string name;
+
+public:
+    long long notifications = 0;
+
+    CountingBidder(string nm) : name(nm) {}
+
+    void placeBid(int bidAmount) override {}
+
+    void receiveBidNotification(string bidderName, int bidAmount) override {
+        notifications++;
+    }
+
+    string getName() override {
+        return name;
+    }
+};
+
+// BidderRegistry class
+// A sparse set: `slots` is indexed by handle and `live` holds the registered bidders back to back.
+// A free slot stores the next free slot in place of its dense index, so the free list needs no
+// extra memory. Unregistering moves the last live entry into the hole, so iteration order is not
+// registration order. A slot is reused after it has been unregistered, but its generation is
+// bumped first, so stale handles to it are rejected by contains(), get() and remove().
+class BidderRegistry {
+    struct Slot {
+        int denseIndex;    // Position in `live` while registered, -1 when free
+        int nextFree;      // Next free slot while free, -1 at the end of the list
+        uint32_t generation = 0; // Bumped every time the slot is freed
+    };
+
+    struct Entry {
+        IBidder *bidder;
+        BidderHandle handle;
+    };
+
+    vector<Slot> slots;
+    vector<Entry> live;
+    int freeHead = -1;
+
+    static uint32_t indexOf(BidderHandle handle) {
+        return (uint32_t)handle;
+    }
+
+    static BidderHandle makeHandle(uint32_t index, uint32_t generation) {
+        return (BidderHandle)generation << 32 | index;
+    }
+
+public:
+    BidderHandle add(IBidder *bidder) {
+        uint32_t index;
+        if (freeHead != -1) {
+            index = freeHead;
+            freeHead = slots[index].nextFree;
+        } else {
+            index = slots.size();
+            slots.push_back(Slot());
+        }
+        slots[index].denseIndex = live.size();
+        slots[index].nextFree = -1;
+        BidderHandle handle = makeHandle(index, slots[index].generation);
+        live.push_back({bidder, handle});
+        return handle;
+    }
+
+    void remove(BidderHandle handle) {
+        if (!tryRemove(handle)) {
+            throw invalid_argument("unknown bidder handle " + to_string(handle));
+        }
+    }
+
+    // Like remove(), but returns false instead of throwing for an unknown or stale handle.
+    bool tryRemove(BidderHandle handle) noexcept {
+        if (!contains(handle)) {
+            return false;
+        }
+        uint32_t index = indexOf(handle);
+        int hole = slots[index].denseIndex;
+        live[hole] = live.back();
+        slots[indexOf(live[hole].handle)].denseIndex = hole;
+        live.pop_back();
+        slots[index].denseIndex = -1;
+        slots[index].nextFree = freeHead;
+        slots[index].generation++;
+        freeHead = index;
+        return true;
+    }
+
+    bool contains(BidderHandle handle) const {
+        uint32_t index = indexOf(handle);
+        return index < slots.size() && slots[index].denseIndex != -1 &&
+               slots[index].generation == (uint32_t)(handle >> 32);
+    }
+
+    IBidder *get(BidderHandle handle) const {
+        return contains(handle) ? live[slots[indexOf(handle)].denseIndex].bidder : nullptr;
+    }
+
+    size_t size() const {
+        return live.size();
+    }
+
+    // Calls f(handle, bidder) for every registered bidder, in storage order.
+    template <typename F>
+    void forEach(F f) const {
+        for (const Entry &entry : live) {
+            f(entry.handle, entry.bidder);
+        }
+    }
+};
+
+// Concrete implementation of the auction mediator backed by the registry
+class AuctionMediator : public IAuctionMediator {
+    BidderRegistry bidders; // Bidders participating in the auction
+
+public:
+    BidderHandle addBidder(IBidder *bidder) override {
+        return bidders.add(bidder);
+    }
+
+    void removeBidder(BidderHandle handle) override {
+        bidders.remove(handle);
+    }
+
+    bool tryRemoveBidder(BidderHandle handle) noexcept override {
+        return bidders.tryRemove(handle);
+    }
+
+    void placeBid(BidderHandle handle, int bidAmount) override {
+        IBidder *bidder = bidders.get(handle);
+        if (bidder == nullptr) {
+            throw invalid_argument("unknown bidder handle " + to_string(handle));
+        }
+        string name = bidder->getName();
+        bidders.forEach([&](BidderHandle other, IBidder *notifyBidder) {
+            if (other != handle) { // Skip the bidder who placed the bid
+                notifyBidder->receiveBidNotification(name, bidAmount);
+            }
+        });
+    }
+
+    size_t size() {
+        return bidders.size();
+    }
+};
+
+// The classic set<IBidder *> mediator, kept as the benchmark baseline.
+class SetAuctionMediator {
+    set<IBidder *> bidders;
+
+public:
+    void addBidder(IBidder *bidder) {
+        bidders.insert(bidder);
+    }
+
+    void removeBidder(IBidder *bidder) {
+        bidders.erase(bidder);
+    }
+
+    void placeBid(IBidder *bidder, int bidAmount) {
+        string name = bidder->getName();
+        for (auto notifyBidder : bidders) {
+            if (notifyBidder != bidder) {
+                notifyBidder->receiveBidNotification(name, bidAmount);
+            }
+        }
+    }
+};
+
+template <typename F>
+double secondsOf(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Registers `bidderCount` bidders, broadcasts `broadcasts` bids and unregisters half of the
+// bidders, with both mediators. Broadcast time is reported per notified bidder.
+void benchmark(int bidderCount, int broadcasts) {
+    vector<unique_ptr<CountingBidder>> bidders;
+    for (int b = 0; b < bidderCount; b++) {
+        bidders.emplace_back(new CountingBidder("bidder" + to_string(b)));
+    }
+    vector<int> order(bidderCount);
+    iota(order.begin(), order.end(), 0);
+    shuffle(order.begin(), order.end(), mt19937(1));
+    double perBroadcast = (double)bidderCount - 1;
+
+    SetAuctionMediator tree;
+    double treeAdd = secondsOf([&]() {
+        for (int b : order) {
+            tree.addBidder(bidders[b].get());
+        }
+    });
+    double treeBroadcast = secondsOf([&]() {
+        for (int i = 0; i < broadcasts; i++) {
+            tree.placeBid(bidders[order[i]].get(), 100 + i);
+        }
+    });
+    double treeRemove = secondsOf([&]() {
+        for (int i = 0; i < bidderCount / 2; i++) {
+            tree.removeBidder(bidders[order[i]].get());
+        }
+    });
+
+    AuctionMediator dense;
+    vector<BidderHandle> handles(bidderCount);
+    double denseAdd = secondsOf([&]() {
+        for (int b : order) {
+            handles[b] = dense.addBidder(bidders[b].get());
+        }
+    });
+    double denseBroadcast = secondsOf([&]() {
+        for (int i = 0; i < broadcasts; i++) {
+            dense.placeBid(handles[order[i]], 100 + i);
+        }
+    });
+    double denseRemove = secondsOf([&]() {
+        for (int i = 0; i < bidderCount / 2; i++) {
+            dense.removeBidder(handles[order[i]]);
+        }
+    });
+
+    cout << fixed << setprecision(2);
+    cout << bidderCount << " bidders        set<IBidder *>   dense registry" << endl;
+    cout << "register (ns/bidder)     " << setw(10) << treeAdd * 1e9 / bidderCount << "   " << setw(10)
+         << denseAdd * 1e9 / bidderCount << endl;
+    cout << "broadcast (ns/bidder)    " << setw(10) << treeBroadcast * 1e9 / broadcasts / perBroadcast << "   "
+         << setw(10) << denseBroadcast * 1e9 / broadcasts / perBroadcast << endl;
+    cout << "unregister (ns/bidder)   " << setw(10) << treeRemove * 1e9 / (bidderCount / 2) << "   " << setw(10)
+         << denseRemove * 1e9 / (bidderCount / 2) << endl;
+}
+
+// Main function to demonstrate the dense bidder registry
+int main() {
+    IAuctionMediator *auctionMediator = new AuctionMediator();
+
+    IBidder *bidder1 = new Bidder("samyak", auctionMediator);
+    Bidder *bidder2 = new Bidder("shreya", auctionMediator);
+    IBidder *bidder3 = new Bidder("aishik", auctionMediator);
+
+    bidder1->placeBid(100);
+    cout << "--------------" << endl;
+
+    // shreya leaves; the slot goes back on the free list and is reused by rahul under a new
+    // generation, so shreya's old handle no longer reaches anyone
+    BidderHandle shreyaHandle = bidder2->getHandle();
+    delete bidder2;
+    IBidder *bidder4 = new Bidder("rahul", auctionMediator);
+    bidder3->placeBid(300);
+    try {
+        auctionMediator->placeBid(shreyaHandle, 400);
+    } catch (const invalid_argument &e) {
+        cout << "stale handle rejected: " << e.what() << endl;
+    }
+
+    cout << "--------------" << endl;
+    benchmark(1000000, 5);
+
+    delete bidder1;
+    delete bidder3;
+    delete bidder4;
+    delete auctionMediator;
+
+    return 0;
+}
@@ -0,0 +1,243 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Mediator Design Pattern with Highest Bid Tracking:
+// The classic AuctionMediator forwards every bid to every other bidder and never decides which
+// bid is winning. In this variant the mediator keeps the current best bid of the auction in a
+// single atomic word and updates it with compare-and-swap. A bid at or below the current best is
+// rejected before any notification is sent, so stale bids, which are most of the traffic in a
+// busy auction, cost one atomic load instead of a broadcast. Bids may be placed from many threads
+// at once without locks.
+
+// Abstract interface for a bidder in the auction
+class IBidder {
+public:
+    virtual void placeBid(int bidAmount) = 0;                // Places a bid
+    virtual void receiveBidNotification(string bidderName, int bidAmount) = 0; // Receives notification of other bids
+    virtual string getName() = 0;                           // Returns the name of the bidder
+    virtual ~IBidder() = default;
+};
+
+// Abstract interface for the mediator
+class IAuctionMediator {
+public:
+    virtual void addBidder(IBidder *bidder) = 0;            // Adds a bidder to the auction
+    virtual bool placeBid(IBidder *bidder, int bidAmount) = 0; // Handles the bid, true if it is the new best
+    virtual ~IAuctionMediator() = default;
+};
+
+// Concrete implementation of a bidder
+class Bidder : public IBidder {
+    string name;                   // Name of the bidder
+    IAuctionMediator *auctionMediator; // Reference to the mediator
+
+public:
+    Bidder(string nm, IAuctionMediator *am) : name(nm), auctionMediator(am) {
+        auctionMediator->addBidder(this); // Register bidder with the mediator
+    }
+
+    // Places a bid and reports whether the mediator accepted it
+    void placeBid(int bidAmount) override {
+        bool accepted = auctionMediator->placeBid(this, bidAmount);
+        cout << name << " placed a bid of " << bidAmount << (accepted ? " (accepted)" : " (rejected, not above the best bid)") << endl;
+    }
+
+    void receiveBidNotification(string bidderName, int bidAmount) override {
+        cout << name << " received notification that " << bidderName << " placed a bid of " << bidAmount << endl;
+    }
+
+    string getName() override {
+        return name;
+    }
+};
+
+// A bidder that only counts notifications, safe to notify from several threads at once.
+class CountingBidder : public IBidder {
+    string name;
+    IAuctionMediator *auctionMediator;
+
+public:
+    atomic<long long> notifications{0};
+
+    CountingBidder(string nm, IAuctionMediator *am) : name(nm), auctionMediator(am) {
+        auctionMediator->addBidder(this);
+    }
+
+    void placeBid(int bidAmount) override {
+        auctionMediator->placeBid(this, bidAmount);
+    }
+
+    void receiveBidNotification(string bidderName, int bidAmount) override {
+        notifications.fetch_add(1, memory_order_relaxed);
+    }
+
+    string getName() override {
+        return name;
+    }
+};
+
+// The classic behaviour, kept as the benchmark baseline: every bid is broadcast.
+class BroadcastAuctionMediator : public IAuctionMediator {
+    vector<IBidder *> bidders;
+
+public:
+    void addBidder(IBidder *bidder) override {
+        bidders.push_back(bidder);
+    }
+
+    bool placeBid(IBidder *bidder, int bidAmount) override {
+        for (auto notifyBidder : bidders) {
+            if (notifyBidder != bidder) {
+                notifyBidder->receiveBidNotification(bidder->getName(), bidAmount);
+            }
+        }
+        return true;
+    }
+};
+
+// Concrete implementation of the auction mediator with highest bid tracking.
+// The best bid is packed into one 64-bit word: the amount in the high half and the index of the
+// bidder who placed it in the low half, so both change together in a single CAS. All bidders must
+// be registered before bidding starts; after that the bidder list is read-only and is shared
+// between threads without synchronization. Notifications for two accepted bids placed at the same
+// time may arrive in either order, so bidders should keep the highest amount they have seen.
+class AuctionMediator : public IAuctionMediator {
+    static const uint32_t NO_BIDDER = UINT32_MAX;
+
+    vector<IBidder *> bidders;   // Collection of bidders participating in the auction
+    unordered_map<IBidder *, uint32_t> bidderIndex;
+    atomic<uint64_t> bestBid;    // (amount << 32) | bidder index
+    atomic<long long> accepted;
+    atomic<long long> rejected;
+
+    static uint64_t pack(int amount, uint32_t bidder) {
+        return ((uint64_t)(uint32_t)amount << 32) | bidder;
+    }
+
+public:
+    AuctionMediator() : bestBid(pack(0, NO_BIDDER)), accepted(0), rejected(0) {}
+
+    void addBidder(IBidder *bidder) override {
+        bidderIndex[bidder] = bidders.size();
+        bidders.push_back(bidder);
+    }
+
+    // Accepts the bid only if it beats the current best, then notifies the other bidders.
+    bool placeBid(IBidder *bidder, int bidAmount) override {
+        if (bidAmount <= 0) {
+            rejected.fetch_add(1, memory_order_relaxed);
+            return false;
+        }
+        uint64_t proposed = pack(bidAmount, bidderIndex.at(bidder));
+        uint64_t current = bestBid.load(memory_order_acquire);
+        do {
+            if ((uint32_t)(current >> 32) >= (uint32_t)bidAmount) {
+                rejected.fetch_add(1, memory_order_relaxed);
+                return false; // Stale: no fan-out at all
+            }
+        } while (!bestBid.compare_exchange_weak(current, proposed, memory_order_acq_rel, memory_order_acquire));
+
+        accepted.fetch_add(1, memory_order_relaxed);
+        string name = bidder->getName();
+        for (auto notifyBidder : bidders) {
+            if (notifyBidder != bidder) { // Skip the bidder who placed the bid
+                notifyBidder->receiveBidNotification(name, bidAmount);
+            }
+        }
+        return true;
+    }
+
+    // Returns the current best bid amount, or 0 if nobody has bid yet.
+    int getBestAmount() {
+        return (int)(bestBid.load() >> 32);
+    }
+
+    // Returns the bidder holding the current best bid, or nullptr if nobody has bid yet.
+    IBidder *getBestBidder() {
+        uint32_t index = (uint32_t)bestBid.load();
+        return index == NO_BIDDER ? nullptr : bidders[index];
+    }
+
+    long long getAccepted() {
+        return accepted.load();
+    }
+
+    long long getRejected() {
+        return rejected.load();
+    }
+};
+
+// Runs `threads` bidding threads against the auction the bidders are registered with. Bid amounts
+// are drawn below a slowly rising ceiling, so most bids are stale, as in a real bidding war.
+double runAuction(vector<unique_ptr<CountingBidder>> &bidders, int threads, int bidsPerThread) {
+    auto start = chrono::steady_clock::now();
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            mt19937 rng(t + 1);
+            for (int i = 0; i < bidsPerThread; i++) {
+                int ceiling = 1000 + i * 4;
+                bidders[rng() % bidders.size()]->placeBid((int)(rng() % ceiling) + 1);
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void benchmark(int bidderCount, int threads, int bidsPerThread) {
+    long long bids = (long long)threads * bidsPerThread;
+
+    BroadcastAuctionMediator broadcast;
+    vector<unique_ptr<CountingBidder>> broadcastBidders;
+    for (int b = 0; b < bidderCount; b++) {
+        broadcastBidders.emplace_back(new CountingBidder("bidder" + to_string(b), &broadcast));
+    }
+    // The broadcast baseline is too slow for the full run; a tenth of the bids is enough.
+    double broadcastSeconds = runAuction(broadcastBidders, threads, bidsPerThread / 10);
+    cout << "broadcast every bid: " << bids / 10 / broadcastSeconds / 1e6 << " M bids/s" << endl;
+
+    AuctionMediator tracked;
+    vector<unique_ptr<CountingBidder>> trackedBidders;
+    for (int b = 0; b < bidderCount; b++) {
+        trackedBidders.emplace_back(new CountingBidder("bidder" + to_string(b), &tracked));
+    }
+    double seconds = runAuction(trackedBidders, threads, bidsPerThread);
+    long long notifications = 0;
+    for (auto &bidder : trackedBidders) {
+        notifications += bidder->notifications.load();
+    }
+    cout << "best bid tracking:   " << bids / seconds / 1e6 << " M bids/s (accepted "
+         << tracked.getAccepted() / seconds / 1e6 << " M/s, rejected " << tracked.getRejected() / seconds / 1e6
+         << " M/s), " << notifications << " notifications, best bid " << tracked.getBestAmount() << endl;
+}
+
+// Main function to demonstrate highest bid tracking
+int main() {
+    AuctionMediator *auctionMediator = new AuctionMediator();
+
+    IBidder *bidder1 = new Bidder("samyak", auctionMediator);
+    IBidder *bidder2 = new Bidder("shreya", auctionMediator);
+    IBidder *bidder3 = new Bidder("aishik", auctionMediator);
+
+    bidder1->placeBid(100);
+    cout << "--------------" << endl;
+    bidder2->placeBid(300);
+    cout << "--------------" << endl;
+    bidder3->placeBid(200); // Stale: rejected without notifying anyone
+    cout << "--------------" << endl;
+    cout << "Best bid is " << auctionMediator->getBestAmount() << " by " << auctionMediator->getBestBidder()->getName() << endl;
+
+    cout << "--------------" << endl;
+    unsigned cores = max(1u, thread::hardware_concurrency());
+    benchmark(1000, (int)min(cores * 2, 16u), 200000);
+
+    delete bidder1;
+    delete bidder2;
+    delete bidder3;
+    delete auctionMediator;
+
+    return 0;
+}
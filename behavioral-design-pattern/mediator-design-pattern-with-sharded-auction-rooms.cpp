@@ -0,0 +1,357 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Mediator Design Pattern with Sharded Auction Rooms:
+// The classic AuctionMediator is a single unsynchronized object running one auction. This
+// variant hosts many auction rooms in an AuctionEngine. Every room is owned by exactly one shard,
+// and every shard has one worker thread and its own lock-free task queue. Bids for different
+// rooms are processed in parallel on different shards without any shared lock, while all bids
+// for one room go through the same worker and are therefore serialized. Bidders talk to a room
+// through a RoomMediator handle, so the Bidder class is unchanged.
+
+// Abstract interface for a bidder in the auction
+class IBidder {
+public:
+    virtual void placeBid(int bidAmount) = 0;                // Places a bid
+    virtual void receiveBidNotification(string bidderName, int bidAmount) = 0; // Receives notification of other bids
+    virtual string getName() = 0;                           // Returns the name of the bidder
+    virtual ~IBidder() = default;
+};
+
+// Abstract interface for the mediator
+class IAuctionMediator {
+public:
+    virtual void addBidder(IBidder *bidder) = 0;            // Adds a bidder to the auction
+    virtual void placeBid(IBidder *bidder, int bidAmount) = 0; // Handles the bid placement
+    virtual ~IAuctionMediator() = default;
+};
+
+// Concrete implementation of a bidder
+class Bidder : public IBidder {
+    string name;                   // Name of the bidder
+    IAuctionMediator *auctionMediator; // Reference to the mediator
+
+public:
+    // Constructor to initialize the bidder and register with the mediator
+    Bidder(string nm, IAuctionMediator *am) : name(nm), auctionMediator(am) {
+        auctionMediator->addBidder(this); // Register bidder with the mediator
+    }
+
+    // Places a bid and notifies the mediator
+    void placeBid(int bidAmount) override {
+        cout << name << " placed a bid of " << bidAmount << endl;
+        auctionMediator->placeBid(this, bidAmount); // Notify mediator of the bid
+    }
+
+    // Receives notification of another bidder's action
+    void receiveBidNotification(string bidderName, int bidAmount) override {
+        cout << name << " received notification that " << bidderName << " placed a bid of " << bidAmount << endl;
+    }
+
+    // Returns the name of the bidder
+    string getName() override {
+        return name;
+    }
+};
+
+// A bidder that only counts its notifications, used by the benchmark. Notifications for a room
+// always arrive on that room's shard thread, so a plain counter is enough.
+class CountingBidder : public IBidder {
+    string name;
+    IAuctionMediator *auctionMediator;
+
+public:
+    long long notifications = 0;
+
+    CountingBidder(string nm, IAuctionMediator *am) : name(nm), auctionMediator(am) {
+        auctionMediator->addBidder(this);
+    }
+
+    void placeBid(int bidAmount) override {
+        auctionMediator->placeBid(this, bidAmount);
+    }
+
+    void receiveBidNotification(string bidderName, int bidAmount) override {
+        notifications++;
+    }
+
+    string getName() override {
+        return name;
+    }
+};
+
+// Concrete implementation of the auction mediator for one room. It is only ever touched by the
+// room's shard thread, so it needs no synchronization of its own.
+class AuctionMediator : public IAuctionMediator {
+    set<IBidder *> bidders; // Collection of bidders participating in the auction
+
+public:
+    AuctionMediator() {
+        bidders.clear();
+    }
+
+    void addBidder(IBidder *bidder) override {
+        bidders.insert(bidder);
+    }
+
+    void placeBid(IBidder *bidder, int bidAmount) override {
+        for (auto notifyBidder : bidders) {
+            if (notifyBidder != bidder) { // Skip the bidder who placed the bid
+                notifyBidder->receiveBidNotification(bidder->getName(), bidAmount);
+            }
+        }
+    }
+};
+
+// A unit of work for a shard: register a bidder in a room or place a bid in it.
+struct AuctionTask {
+    enum Kind { ADD_BIDDER, PLACE_BID };
+
+    Kind kind;
+    int roomId;
+    IBidder *bidder;
+    int bidAmount;
+    atomic<AuctionTask *> next;
+};
+
+// Multi-producer single-consumer queue (Vyukov's intrusive design). Any thread may push with a
+// single atomic exchange; only the shard's worker pops.
+class TaskQueue {
+    alignas(64) atomic<AuctionTask *> head; // Producers push here
+    alignas(64) AuctionTask *tail;          // Consumer pops here
+    AuctionTask stub;
+
+public:
+    TaskQueue() {
+        stub.next.store(nullptr);
+        head.store(&stub);
+        tail = &stub;
+    }
+
+    void push(AuctionTask *task) {
+        task->next.store(nullptr, memory_order_relaxed);
+        AuctionTask *previous = head.exchange(task, memory_order_acq_rel);
+        previous->next.store(task, memory_order_release);
+    }
+
+    // Returns the oldest task, or nullptr if the queue is empty or a push is half done.
+    AuctionTask *pop() {
+        AuctionTask *first = tail;
+        AuctionTask *next = first->next.load(memory_order_acquire);
+        if (first == &stub) {
+            if (next == nullptr) {
+                return nullptr;
+            }
+            tail = next;
+            first = next;
+            next = next->next.load(memory_order_acquire);
+        }
+        if (next != nullptr) {
+            tail = next;
+            return first;
+        }
+        if (first != head.load(memory_order_acquire)) {
+            return nullptr; // A producer is between its exchange and its link; retry later
+        }
+        push(&stub);
+        next = first->next.load(memory_order_acquire);
+        if (next != nullptr) {
+            tail = next;
+            return first;
+        }
+        return nullptr;
+    }
+};
+
+// One shard: a worker thread, its task queue and the rooms it owns.
+class AuctionShard {
+    TaskQueue queue;
+    unordered_map<int, AuctionMediator> rooms; // Only touched by the worker thread
+    atomic<long long> submitted;
+    atomic<long long> processed;
+    atomic<bool> stopping;
+    thread worker;
+
+    void run() {
+        int idleRounds = 0;
+        while (true) {
+            AuctionTask *task = queue.pop();
+            if (task == nullptr) {
+                if (stopping.load(memory_order_acquire) && processed.load() == submitted.load()) {
+                    break;
+                }
+                if (++idleRounds < 64) {
+                    this_thread::yield();
+                } else {
+                    this_thread::sleep_for(chrono::microseconds(50));
+                }
+                continue;
+            }
+            idleRounds = 0;
+            AuctionMediator &room = rooms[task->roomId];
+            if (task->kind == AuctionTask::ADD_BIDDER) {
+                room.addBidder(task->bidder);
+            } else {
+                room.placeBid(task->bidder, task->bidAmount);
+            }
+            delete task;
+            processed.fetch_add(1, memory_order_release);
+        }
+    }
+
+public:
+    AuctionShard() : submitted(0), processed(0), stopping(false) {
+        worker = thread(&AuctionShard::run, this);
+    }
+
+    // Finishes every queued task, then stops the worker.
+    ~AuctionShard() {
+        stopping.store(true, memory_order_release);
+        worker.join();
+    }
+
+    void submit(AuctionTask::Kind kind, int roomId, IBidder *bidder, int bidAmount) {
+        AuctionTask *task = new AuctionTask();
+        task->kind = kind;
+        task->roomId = roomId;
+        task->bidder = bidder;
+        task->bidAmount = bidAmount;
+        submitted.fetch_add(1, memory_order_relaxed);
+        queue.push(task);
+    }
+
+    bool isIdle() {
+        return processed.load(memory_order_acquire) == submitted.load(memory_order_acquire);
+    }
+};
+
+// The AuctionEngine owns the shards and maps every room to one of them.
+class AuctionEngine {
+    vector<unique_ptr<AuctionShard>> shards;
+    atomic<int> nextRoomId;
+
+public:
+    AuctionEngine(int shardCount) : nextRoomId(0) {
+        for (int i = 0; i < shardCount; i++) {
+            shards.emplace_back(new AuctionShard());
+        }
+    }
+
+    // Returns the id of a new, empty auction room.
+    int createRoom() {
+        return nextRoomId.fetch_add(1);
+    }
+
+    // Queues a bidder registration on the room's shard. Safe to call from any thread.
+    void addBidder(int roomId, IBidder *bidder) {
+        shards[roomId % shards.size()]->submit(AuctionTask::ADD_BIDDER, roomId, bidder, 0);
+    }
+
+    // Queues a bid on the room's shard. Safe to call from any thread.
+    void placeBid(int roomId, IBidder *bidder, int bidAmount) {
+        shards[roomId % shards.size()]->submit(AuctionTask::PLACE_BID, roomId, bidder, bidAmount);
+    }
+
+    // Waits until every task queued so far has been processed.
+    void waitIdle() {
+        for (auto &shard : shards) {
+            while (!shard->isIdle()) {
+                this_thread::yield();
+            }
+        }
+    }
+};
+
+// RoomMediator class
+// The IAuctionMediator a bidder sees: a handle to one room of the engine.
+class RoomMediator : public IAuctionMediator {
+    AuctionEngine *engine;
+    int roomId;
+
+public:
+    RoomMediator(AuctionEngine *e) : engine(e), roomId(e->createRoom()) {}
+
+    void addBidder(IBidder *bidder) override {
+        engine->addBidder(roomId, bidder);
+    }
+
+    void placeBid(IBidder *bidder, int bidAmount) override {
+        engine->placeBid(roomId, bidder, bidAmount);
+    }
+};
+
+// Places bids into many rooms from several producer threads and reports bids per second.
+void benchmark(int shardCount, int producerCount, int roomCount, int biddersPerRoom, int bidsPerProducer) {
+    AuctionEngine engine(shardCount);
+    vector<unique_ptr<RoomMediator>> rooms;
+    vector<unique_ptr<CountingBidder>> bidders;
+    for (int r = 0; r < roomCount; r++) {
+        rooms.emplace_back(new RoomMediator(&engine));
+        for (int b = 0; b < biddersPerRoom; b++) {
+            bidders.emplace_back(new CountingBidder("bidder" + to_string(b), rooms.back().get()));
+        }
+    }
+    engine.waitIdle();
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> producers;
+    for (int p = 0; p < producerCount; p++) {
+        producers.emplace_back([&, p]() {
+            mt19937 rng(p);
+            for (int i = 0; i < bidsPerProducer; i++) {
+                int room = rng() % roomCount;
+                bidders[room * biddersPerRoom + rng() % biddersPerRoom]->placeBid(100 + i);
+            }
+        });
+    }
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    engine.waitIdle();
+    auto end = chrono::steady_clock::now();
+
+    long long notifications = 0;
+    for (auto &bidder : bidders) {
+        notifications += bidder->notifications;
+    }
+    double seconds = chrono::duration<double>(end - start).count();
+    long long bids = (long long)producerCount * bidsPerProducer;
+    cout << "shards=" << shardCount << " producers=" << producerCount << " rooms=" << roomCount
+         << ": " << bids / seconds / 1e6 << " M bids/s (" << notifications << " notifications)" << endl;
+}
+
+// Main function to demonstrate the sharded auction engine
+int main() {
+    AuctionEngine *engine = new AuctionEngine(2);
+    IAuctionMediator *room1 = new RoomMediator(engine);
+    IAuctionMediator *room2 = new RoomMediator(engine);
+
+    // Two auctions running on different shards
+    IBidder *bidder1 = new Bidder("samyak", room1);
+    IBidder *bidder2 = new Bidder("shreya", room1);
+    IBidder *bidder3 = new Bidder("aishik", room2);
+    IBidder *bidder4 = new Bidder("rahul", room2);
+    engine->waitIdle();
+
+    bidder1->placeBid(100);
+    engine->waitIdle();
+    cout << "--------------" << endl;
+    bidder3->placeBid(300);
+    engine->waitIdle();
+
+    cout << "--------------" << endl;
+    unsigned cores = max(1u, thread::hardware_concurrency());
+    for (int shards : {1, 2, 4, 8}) {
+        benchmark(shards, (int)min(cores, 4u), 10000, 8, 200000);
+    }
+
+    delete engine;
+    delete bidder1;
+    delete bidder2;
+    delete bidder3;
+    delete bidder4;
+    delete room1;
+    delete room2;
+
+    return 0;
+}
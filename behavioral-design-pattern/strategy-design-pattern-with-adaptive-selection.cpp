@@ -0,0 +1,358 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Strategy Design Pattern with Adaptive Selection:
+// Sometimes the strategies behind one interface are not different behaviours but different
+// implementations of the same one, and which is fastest depends on the input and the machine.
+// This variant adds AdaptiveDrive, a DriveStrategy that holds several interchangeable candidates.
+// It times each of them during a warm-up phase, then runs the fastest, still timing a sample of
+// calls and now and then re-trying the others (bandit style), so it switches when the input
+// changes. It reports which candidate is chosen and its measured latency. The Vehicle class is
+// unchanged: it just gets an AdaptiveDrive as its strategy.
+
+// A route: the speed limit (km/h) of each 100 m segment.
+struct Route {
+    vector<uint8_t> limits;
+};
+
+// Length of a route segment, in km.
+static const double SEGMENT_KM = 0.1;
+
+// Abstract Strategy Class
+// A drive strategy computes how long a vehicle cruising at `cruiseSpeed` takes to drive a route,
+// slowing down wherever the limit is lower. All concrete strategies return identical results.
+class DriveStrategy {
+public:
+    // Returns the travel time over the route, in hours.
+    virtual double drive(const Route& route, int cruiseSpeed) = 0;
+    // Name of the implementation.
+    virtual string describe() = 0;
+    virtual ~DriveStrategy() = default; // Virtual destructor for proper cleanup of derived classes.
+};
+
+// Concrete Strategy: a plain branch per segment. Fast when limits are predictable, e.g. on a
+// highway where the limit is almost never below the cruise speed.
+class BranchingDrive : public DriveStrategy {
+public:
+    double drive(const Route& route, int cruiseSpeed) override {
+        double cruiseHours = SEGMENT_KM / cruiseSpeed;
+        double hours = 0;
+        for (uint8_t limit : route.limits) {
+            if (limit < cruiseSpeed) {
+                hours += SEGMENT_KM / limit;
+            } else {
+                hours += cruiseHours;
+            }
+        }
+        return hours;
+    }
+
+    string describe() override {
+        return "branching";
+    }
+};
+
+// Concrete Strategy: no data-dependent branch, so it does not suffer from mispredictions when
+// limits change erratically, at the price of always doing the division.
+class BranchlessDrive : public DriveStrategy {
+public:
+    double drive(const Route& route, int cruiseSpeed) override {
+        double hours = 0;
+        for (uint8_t limit : route.limits) {
+            int speed = min<int>(limit, cruiseSpeed);
+            hours += SEGMENT_KM / speed;
+        }
+        return hours;
+    }
+
+    string describe() override {
+        return "branchless";
+    }
+};
+
+// Concrete Strategy: looks the segment time up in a table indexed by limit, rebuilt whenever the
+// cruise speed changes. No division per segment, but a table rebuild per new cruise speed.
+class LookupDrive : public DriveStrategy {
+    array<double, 256> segmentHours;
+    int tableSpeed = -1;
+
+public:
+    double drive(const Route& route, int cruiseSpeed) override {
+        if (cruiseSpeed != tableSpeed) {
+            for (int limit = 1; limit < 256; limit++) {
+                segmentHours[limit] = SEGMENT_KM / min(limit, cruiseSpeed);
+            }
+            segmentHours[0] = SEGMENT_KM / 0.0;
+            tableSpeed = cruiseSpeed;
+        }
+        double hours = 0;
+        for (uint8_t limit : route.limits) {
+            hours += segmentHours[limit];
+        }
+        return hours;
+    }
+
+    string describe() override {
+        return "lookup";
+    }
+};
+
+// AdaptiveDrive class
+// Holds the candidates and picks one per call:
+//   warm-up  each candidate runs `warmupRuns` times, round robin, and every run is timed;
+//   exploit  the candidate with the lowest average latency runs, and every `sampleEvery`-th call
+//            of it is timed to keep its estimate current;
+//   explore  every `exploreEvery`-th call runs the next other candidate instead, timed, so a
+//            candidate that became faster is noticed.
+// Latency is tracked per route segment, as an exponentially weighted moving average, so routes of
+// different lengths are comparable. A challenger must beat the chosen candidate by `margin` to
+// replace it, which keeps timing noise from flipping the choice. Not thread-safe, like the
+// Vehicle it serves.
+class AdaptiveDrive : public DriveStrategy {
+    struct Candidate {
+        unique_ptr<DriveStrategy> strategy;
+        double nanosPerSegment = 0;   // Moving average
+        long long timedRuns = 0;
+        long long runs = 0;
+    };
+
+    vector<Candidate> candidates;
+    int warmupRuns;
+    int sampleEvery;
+    int exploreEvery;
+    double smoothing;
+    double margin;
+    size_t best = 0;
+    size_t nextExplore = 0;
+    long long calls = 0;
+    long long switches = 0;
+
+    bool isWarmupCall(long long call) {
+        return call < (long long)warmupRuns * (long long)candidates.size();
+    }
+
+    double timedRun(Candidate& candidate, const Route& route, int cruiseSpeed) {
+        auto start = chrono::steady_clock::now();
+        double hours = candidate.strategy->drive(route, cruiseSpeed);
+        double nanos = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        double perSegment = nanos / max<size_t>(1, route.limits.size());
+        candidate.nanosPerSegment = candidate.timedRuns == 0
+                                        ? perSegment
+                                        : smoothing * perSegment + (1 - smoothing) * candidate.nanosPerSegment;
+        candidate.timedRuns++;
+        candidate.runs++;
+        return hours;
+    }
+
+    void chooseBest() {
+        size_t fastest = best;
+        for (size_t i = 0; i < candidates.size(); i++) {
+            if (candidates[i].timedRuns > 0 && candidates[i].nanosPerSegment < candidates[fastest].nanosPerSegment) {
+                fastest = i;
+            }
+        }
+        if (fastest != best && candidates[fastest].nanosPerSegment * (1 + margin) < candidates[best].nanosPerSegment) {
+            best = fastest;
+            switches++;
+        }
+    }
+
+public:
+    AdaptiveDrive(int warmup = 5, int sample = 16, int explore = 64, double alpha = 0.25, double minGain = 0.05)
+        : warmupRuns(warmup), sampleEvery(sample), exploreEvery(explore), smoothing(alpha), margin(minGain) {}
+
+    // Adds a candidate implementation, taking ownership of it.
+    void addCandidate(DriveStrategy* strategy) {
+        Candidate candidate;
+        candidate.strategy.reset(strategy);
+        candidates.push_back(move(candidate));
+    }
+
+    double drive(const Route& route, int cruiseSpeed) override {
+        if (candidates.empty()) {
+            throw logic_error("AdaptiveDrive: no candidates");
+        }
+        long long call = calls++;
+        if (isWarmupCall(call)) {
+            double hours = timedRun(candidates[call % candidates.size()], route, cruiseSpeed);
+            if (!isWarmupCall(call + 1)) {
+                chooseBest();
+            }
+            return hours;
+        }
+        if (candidates.size() > 1 && call % exploreEvery == 0) {
+            nextExplore = (nextExplore + 1) % candidates.size();
+            if (nextExplore == best) {
+                nextExplore = (nextExplore + 1) % candidates.size();
+            }
+            double hours = timedRun(candidates[nextExplore], route, cruiseSpeed);
+            chooseBest();
+            return hours;
+        }
+        Candidate& chosen = candidates[best];
+        if (call % sampleEvery == 0) {
+            double hours = timedRun(chosen, route, cruiseSpeed);
+            chooseBest();
+            return hours;
+        }
+        chosen.runs++;
+        return chosen.strategy->drive(route, cruiseSpeed);
+    }
+
+    string describe() override {
+        return "adaptive (" + chosen() + ")";
+    }
+
+    // Name of the candidate currently chosen.
+    string chosen() {
+        return candidates.empty() ? "none" : candidates[best].strategy->describe();
+    }
+
+    // Measured latency of the chosen candidate, in nanoseconds per route segment.
+    double chosenLatency() {
+        return candidates.empty() ? 0 : candidates[best].nanosPerSegment;
+    }
+
+    long long getSwitches() {
+        return switches;
+    }
+
+    void printStats(ostream& out) {
+        for (size_t i = 0; i < candidates.size(); i++) {
+            out << "  " << (i == best ? "* " : "  ") << setw(10) << left << candidates[i].strategy->describe() << right
+                << setw(8) << fixed << setprecision(2) << candidates[i].nanosPerSegment << " ns/segment, "
+                << candidates[i].runs << " runs" << endl;
+        }
+    }
+};
+
+// Vehicle class
+// This class represents a vehicle that can change its driving strategy dynamically.
+// It holds a reference to a DriveStrategy and delegates the driving behavior to the strategy.
+class Vehicle {
+protected:
+    unique_ptr<DriveStrategy> driveStrategy; // Current driving strategy, owned by the vehicle
+    int cruiseSpeed;
+
+public:
+    Vehicle(DriveStrategy* strategy, int speed) : driveStrategy(strategy), cruiseSpeed(speed) {}
+
+    // Replaces the current driving strategy, taking ownership of the new one.
+    void setDriveStrategy(DriveStrategy* strategy) {
+        driveStrategy.reset(strategy);
+    }
+
+    void setCruiseSpeed(int speed) {
+        cruiseSpeed = speed;
+    }
+
+    // Drives a route and returns the travel time in hours.
+    double performDrive(const Route& route) {
+        return driveStrategy->drive(route, cruiseSpeed);
+    }
+
+    virtual ~Vehicle() = default;
+};
+
+// A highway: limits above the cruise speed with rare roadworks.
+Route highwayRoute(size_t segments, mt19937& rng) {
+    Route route;
+    for (size_t i = 0; i < segments; i++) {
+        route.limits.push_back(rng() % 200 == 0 ? 80 : 130);
+    }
+    return route;
+}
+
+// A city: limits change erratically from one segment to the next.
+Route cityRoute(size_t segments, mt19937& rng) {
+    static const uint8_t LIMITS[] = {30, 50, 60, 130};
+    Route route;
+    for (size_t i = 0; i < segments; i++) {
+        route.limits.push_back(LIMITS[rng() % 4]);
+    }
+    return route;
+}
+
+// A benchmark phase: routes driven in turn, optionally with a new cruise speed on every call.
+struct Phase {
+    string name;
+    vector<Route> routes;
+    bool varyingSpeed;
+};
+
+// Drives the same sequence of phases with each fixed candidate and with AdaptiveDrive. Long
+// highway routes favour branching, long city routes favour lookup, and short routes with a new
+// cruise speed each time make lookup rebuild its table on every call.
+void benchmark(size_t segments, int callsPerPhase) {
+    mt19937 rng(3);
+    vector<Phase> phases = {{"highway", {highwayRoute(segments, rng)}, false},
+                            {"city", {cityRoute(segments, rng)}, false},
+                            {"suburbs", {}, true},
+                            {"highway", {highwayRoute(segments, rng)}, false}};
+    for (int i = 0; i < 64; i++) {
+        phases[2].routes.push_back(cityRoute(32, rng));
+    }
+
+    auto runPhases = [&](Vehicle& vehicle, AdaptiveDrive* adaptive, double& checksum) {
+        auto start = chrono::steady_clock::now();
+        for (auto& phase : phases) {
+            int calls = phase.varyingSpeed ? callsPerPhase * 32 : callsPerPhase;
+            for (int i = 0; i < calls; i++) {
+                vehicle.setCruiseSpeed(phase.varyingSpeed ? 80 + i % 41 : 120);
+                checksum += vehicle.performDrive(phase.routes[i % phase.routes.size()]);
+            }
+            if (adaptive != nullptr) {
+                cout << "  after " << setw(7) << left << phase.name << right << " chose " << setw(10) << left
+                     << adaptive->chosen() << right << " at " << fixed << setprecision(2) << adaptive->chosenLatency()
+                     << " ns/segment" << endl;
+            }
+        }
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    };
+
+    vector<DriveStrategy*> fixedCandidates = {new BranchingDrive(), new BranchlessDrive(), new LookupDrive()};
+    double expected = -1;
+    for (DriveStrategy* candidate : fixedCandidates) {
+        string name = candidate->describe();
+        Vehicle vehicle(candidate, 120);
+        double checksum = 0;
+        double millis = runPhases(vehicle, nullptr, checksum);
+        expected = checksum;
+        cout << "fixed " << setw(10) << left << name << right << ": " << fixed << setprecision(1) << millis << " ms"
+             << endl;
+    }
+
+    AdaptiveDrive* adaptive = new AdaptiveDrive();
+    adaptive->addCandidate(new BranchingDrive());
+    adaptive->addCandidate(new BranchlessDrive());
+    adaptive->addCandidate(new LookupDrive());
+    Vehicle vehicle(adaptive, 120);
+    double checksum = 0;
+    double millis = runPhases(vehicle, adaptive, checksum);
+    cout << "adaptive        : " << fixed << setprecision(1) << millis << " ms, " << adaptive->getSwitches()
+         << " switches, same result " << (checksum == expected ? "yes" : "NO") << endl;
+    adaptive->printStats(cout);
+}
+
+// Main function
+int main() {
+    mt19937 rng(1);
+    Route commute = cityRoute(1000, rng);
+
+    AdaptiveDrive* adaptive = new AdaptiveDrive();
+    adaptive->addCandidate(new BranchingDrive());
+    adaptive->addCandidate(new BranchlessDrive());
+    adaptive->addCandidate(new LookupDrive());
+    Vehicle* car = new Vehicle(adaptive, 90);
+
+    double hours = 0;
+    for (int i = 0; i < 200; i++) {
+        hours = car->performDrive(commute);
+    }
+    cout << "Commute takes " << fixed << setprecision(1) << hours * 60 << " minutes, driving "
+         << adaptive->describe() << " at " << setprecision(2) << adaptive->chosenLatency() << " ns/segment" << endl;
+    delete car;
+
+    cout << "--------------" << endl;
+    benchmark(4096, 3000);
+}
@@ -0,0 +1,358 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Strategy Design Pattern with a Data-Oriented Fleet:
+// In the classic design every Vehicle is its own heap object pointing to its own heap strategy,
+// so driving a million vehicles means a million pointer chases and a million indirect calls. This
+// variant adds a FleetEngine that stores vehicle state as structure-of-arrays and partitions the
+// vehicles by their active strategy. A tick makes one call per strategy, and that call runs the
+// strategy over its whole partition in a tight loop the compiler can vectorize. Changing a
+// vehicle's strategy moves its state from one partition to another.
+
+// State a drive strategy advances on every step.
+struct MotionState {
+    double speed = 0;     // km/h
+    double distance = 0;  // km
+};
+
+// Length of one simulation step, in hours.
+static const double STEP_HOURS = 1.0 / 3600;
+
+// Abstract Strategy Class
+// This class defines the interface for various driving strategies. Besides the per-vehicle
+// `drive`, a strategy can drive a whole partition of vehicles at once; the default does that one
+// vehicle at a time, so any strategy works in the fleet engine, and the built-in strategies
+// override it with a batch loop.
+class DriveStrategy {
+public:
+    // Advances one vehicle by one simulation step.
+    virtual void drive(MotionState& state) = 0;
+
+    // Advances `count` vehicles whose speeds and distances are stored in two parallel arrays.
+    virtual void driveAll(double* speed, double* distance, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            MotionState state = {speed[i], distance[i]};
+            drive(state);
+            speed[i] = state.speed;
+            distance[i] = state.distance;
+        }
+    }
+
+    // Describes the driving mode.
+    virtual string describe() = 0;
+    virtual ~DriveStrategy() = default; // Virtual destructor for proper cleanup of derived classes.
+};
+
+// Concrete Strategy for Sports vehicles
+// Accelerates hard up to a high top speed.
+class SportDrive : public DriveStrategy {
+public:
+    static void step(double& speed, double& distance) {
+        speed = min(speed + 12.0, 250.0);
+        distance += speed * STEP_HOURS;
+    }
+
+    void drive(MotionState& state) override {
+        step(state.speed, state.distance);
+    }
+
+    void driveAll(double* __restrict speed, double* __restrict distance, size_t count) override {
+        for (size_t i = 0; i < count; i++) {
+            step(speed[i], distance[i]);
+        }
+    }
+
+    string describe() override {
+        return "Driving in Sport mode: High speed, sharp handling!";
+    }
+};
+
+// Concrete Strategy for Normal vehicles
+// Accelerates moderately up to a legal cruising speed.
+class NormalDrive : public DriveStrategy {
+public:
+    static void step(double& speed, double& distance) {
+        speed = min(speed + 5.0, 120.0);
+        distance += speed * STEP_HOURS;
+    }
+
+    void drive(MotionState& state) override {
+        step(state.speed, state.distance);
+    }
+
+    void driveAll(double* __restrict speed, double* __restrict distance, size_t count) override {
+        for (size_t i = 0; i < count; i++) {
+            step(speed[i], distance[i]);
+        }
+    }
+
+    string describe() override {
+        return "Driving in Normal mode: Balanced speed and comfort.";
+    }
+};
+
+// Concrete Strategy for Passenger vehicles
+// Eases towards a comfortable speed without sudden changes.
+class PassengerDrive : public DriveStrategy {
+public:
+    static void step(double& speed, double& distance) {
+        speed += (90.0 - speed) * 0.1;
+        distance += speed * STEP_HOURS;
+    }
+
+    void drive(MotionState& state) override {
+        step(state.speed, state.distance);
+    }
+
+    void driveAll(double* __restrict speed, double* __restrict distance, size_t count) override {
+        for (size_t i = 0; i < count; i++) {
+            step(speed[i], distance[i]);
+        }
+    }
+
+    string describe() override {
+        return "Driving in Passenger mode: Smooth and comfortable ride.";
+    }
+};
+
+// Vehicle class
+// The classic heap-allocated vehicle, kept as the benchmark baseline.
+class Vehicle {
+protected:
+    unique_ptr<DriveStrategy> driveStrategy; // Current driving strategy, owned by the vehicle
+    MotionState state;
+
+public:
+    Vehicle(DriveStrategy* strategy) : driveStrategy(strategy) {}
+
+    void setDriveStrategy(DriveStrategy* strategy) {
+        driveStrategy.reset(strategy);
+    }
+
+    void performDrive() {
+        driveStrategy->drive(state);
+    }
+
+    const MotionState& getState() {
+        return state;
+    }
+
+    virtual ~Vehicle() = default;
+};
+
+typedef uint32_t VehicleId;
+typedef uint32_t StrategyId;
+
+// FleetEngine class
+// Owns the strategies and the state of every vehicle. Each strategy has a partition holding the
+// speeds, distances and ids of the vehicles currently using it, packed without gaps; a directory
+// indexed by VehicleId records where each vehicle lives. Moving a vehicle swaps the last entry of
+// its old partition into the hole and appends the vehicle to the new partition, so a move is O(1)
+// but does not keep the order within a partition.
+class FleetEngine {
+    struct Partition {
+        vector<double> speed;
+        vector<double> distance;
+        vector<VehicleId> vehicle;
+    };
+
+    struct Location {
+        StrategyId strategy;
+        uint32_t index;
+    };
+
+    vector<unique_ptr<DriveStrategy>> strategies;
+    vector<Partition> partitions;      // One per strategy, same index
+    vector<Location> directory;        // Indexed by VehicleId
+
+    void checkStrategy(StrategyId strategy) {
+        if (strategy >= strategies.size()) {
+            throw out_of_range("FleetEngine: unknown strategy " + to_string(strategy));
+        }
+    }
+
+    void checkVehicle(VehicleId vehicle) {
+        if (vehicle >= directory.size()) {
+            throw out_of_range("FleetEngine: unknown vehicle " + to_string(vehicle));
+        }
+    }
+
+    void append(StrategyId strategy, VehicleId vehicle, MotionState state) {
+        Partition& partition = partitions[strategy];
+        directory[vehicle] = {strategy, (uint32_t)partition.vehicle.size()};
+        partition.speed.push_back(state.speed);
+        partition.distance.push_back(state.distance);
+        partition.vehicle.push_back(vehicle);
+    }
+
+public:
+    // Registers a strategy, taking ownership of it, and returns its id.
+    StrategyId addStrategy(DriveStrategy* strategy) {
+        strategies.emplace_back(strategy);
+        partitions.emplace_back();
+        return strategies.size() - 1;
+    }
+
+    // Reserves room for `count` vehicles in total and `perStrategy` vehicles in each partition.
+    void reserve(size_t count, size_t perStrategy) {
+        directory.reserve(count);
+        for (Partition& partition : partitions) {
+            partition.speed.reserve(perStrategy);
+            partition.distance.reserve(perStrategy);
+            partition.vehicle.reserve(perStrategy);
+        }
+    }
+
+    VehicleId addVehicle(StrategyId strategy, MotionState state = MotionState()) {
+        checkStrategy(strategy);
+        VehicleId vehicle = directory.size();
+        directory.push_back(Location());
+        append(strategy, vehicle, state);
+        return vehicle;
+    }
+
+    // Moves a vehicle to another strategy's partition, keeping its motion state.
+    void setDriveStrategy(VehicleId vehicle, StrategyId strategy) {
+        checkVehicle(vehicle);
+        checkStrategy(strategy);
+        Location from = directory[vehicle];
+        if (from.strategy == strategy) {
+            return;
+        }
+        Partition& old = partitions[from.strategy];
+        MotionState state = {old.speed[from.index], old.distance[from.index]};
+        VehicleId last = old.vehicle.back();
+        old.speed[from.index] = old.speed.back();
+        old.distance[from.index] = old.distance.back();
+        old.vehicle[from.index] = last;
+        directory[last].index = from.index;
+        old.speed.pop_back();
+        old.distance.pop_back();
+        old.vehicle.pop_back();
+        append(strategy, vehicle, state);
+    }
+
+    // Advances every vehicle by one step: one call per strategy over its whole partition.
+    void tick() {
+        for (size_t s = 0; s < strategies.size(); s++) {
+            Partition& partition = partitions[s];
+            strategies[s]->driveAll(partition.speed.data(), partition.distance.data(), partition.vehicle.size());
+        }
+    }
+
+    MotionState getState(VehicleId vehicle) {
+        checkVehicle(vehicle);
+        Location at = directory[vehicle];
+        return {partitions[at.strategy].speed[at.index], partitions[at.strategy].distance[at.index]};
+    }
+
+    string describe(VehicleId vehicle) {
+        checkVehicle(vehicle);
+        return strategies[directory[vehicle].strategy]->describe();
+    }
+
+    size_t size() {
+        return directory.size();
+    }
+
+    double totalDistance() {
+        double sum = 0;
+        for (Partition& partition : partitions) {
+            sum = accumulate(partition.distance.begin(), partition.distance.end(), sum);
+        }
+        return sum;
+    }
+};
+
+template <typename F>
+double secondsOf(F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Drives `vehicleCount` vehicles, spread evenly over the three strategies, on a single core with
+// the classic heap vehicles and with the fleet engine, and measures strategy changes.
+void benchmark(uint32_t vehicleCount, int ticks) {
+    cout << fixed << setprecision(1);
+    double checksum = 0;
+
+    {
+        vector<unique_ptr<Vehicle>> vehicles;
+        vehicles.reserve(vehicleCount);
+        for (uint32_t i = 0; i < vehicleCount; i++) {
+            switch (i % 3) {
+            case 0: vehicles.emplace_back(new Vehicle(new SportDrive())); break;
+            case 1: vehicles.emplace_back(new Vehicle(new NormalDrive())); break;
+            default: vehicles.emplace_back(new Vehicle(new PassengerDrive())); break;
+            }
+        }
+        double seconds = secondsOf([&]() {
+            for (int t = 0; t < ticks; t++) {
+                for (auto& vehicle : vehicles) {
+                    vehicle->performDrive();
+                }
+            }
+        });
+        for (auto& vehicle : vehicles) {
+            checksum += vehicle->getState().distance;
+        }
+        cout << "heap vehicles:  " << setw(8) << (double)vehicleCount * ticks / seconds / 1e6
+             << " M vehicles/s per core" << endl;
+    }
+
+    FleetEngine fleet;
+    StrategyId strategyIds[3] = {fleet.addStrategy(new SportDrive()), fleet.addStrategy(new NormalDrive()),
+                                 fleet.addStrategy(new PassengerDrive())};
+    fleet.reserve(vehicleCount, vehicleCount / 3 + vehicleCount / 100 + 1);
+    for (uint32_t i = 0; i < vehicleCount; i++) {
+        fleet.addVehicle(strategyIds[i % 3]);
+    }
+    double seconds = secondsOf([&]() {
+        for (int t = 0; t < ticks; t++) {
+            fleet.tick();
+        }
+    });
+    checksum += fleet.totalDistance();
+    cout << "fleet engine:   " << setw(8) << (double)vehicleCount * ticks / seconds / 1e6
+         << " M vehicles/s per core" << endl;
+
+    // Move 1% of the vehicles to a random strategy, then tick again with the reshuffled partitions
+    mt19937 rng(1);
+    uint32_t moves = vehicleCount / 100;
+    double moveSeconds = secondsOf([&]() {
+        for (uint32_t i = 0; i < moves; i++) {
+            fleet.setDriveStrategy(rng() % vehicleCount, strategyIds[rng() % 3]);
+        }
+    });
+    double afterMoves = secondsOf([&]() { fleet.tick(); });
+    checksum += fleet.totalDistance();
+    cout << "strategy moves: " << setw(8) << moves / moveSeconds / 1e6 << " M moves/s, next tick "
+         << vehicleCount / afterMoves / 1e6 << " M vehicles/s" << endl;
+    cout << "(checksum " << checksum << " km)" << endl;
+}
+
+// Main function
+int main() {
+    FleetEngine fleet;
+    StrategyId sport = fleet.addStrategy(new SportDrive());
+    StrategyId passenger = fleet.addStrategy(new PassengerDrive());
+
+    VehicleId car = fleet.addVehicle(sport);
+    VehicleId bus = fleet.addVehicle(passenger);
+    for (int i = 0; i < 20; i++) {
+        fleet.tick();
+    }
+    cout << fleet.describe(car) << " Speed " << fleet.getState(car).speed << " km/h" << endl;
+    cout << fleet.describe(bus) << " Speed " << fleet.getState(bus).speed << " km/h" << endl;
+
+    // The car calms down: it moves to the passenger partition with its state
+    fleet.setDriveStrategy(car, passenger);
+    for (int i = 0; i < 20; i++) {
+        fleet.tick();
+    }
+    cout << fleet.describe(car) << " Speed " << fleet.getState(car).speed << " km/h" << endl;
+
+    cout << "--------------" << endl;
+    benchmark(10000000, 10);
+}
@@ -0,0 +1,390 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Strategy Design Pattern with RCU Hot Swap:
+// In the classic Vehicle, setDriveStrategy overwrites a raw pointer that performDrive() may be
+// reading on another thread, which is a data race, and the replaced strategy is leaked. In this
+// variant the strategy pointer is atomic and is replaced read-copy-update style: a new strategy
+// is published with one atomic exchange, readers call whatever strategy they load without taking
+// a lock, and the old strategy is handed to an RcuDomain that deletes it only after every reader
+// thread has passed a quiescent state, the point where it holds no strategy pointer any more.
+// Readers never write shared memory per call, so performDrive() costs the same as before.
+
+// State a drive strategy advances on every call.
+struct MotionState {
+    double speed = 0;     // km/h
+    double distance = 0;  // km
+};
+
+// Length of one simulation step, in hours.
+static const double STEP_HOURS = 1.0 / 3600;
+
+// Abstract Strategy Class
+// This class defines the interface for various driving strategies. Each specific driving
+// strategy (e.g., SportDrive, NormalDrive) will implement the `drive` method.
+class DriveStrategy {
+public:
+    // Advances the vehicle by one simulation step.
+    virtual void drive(MotionState& state) = 0;
+    // Describes the driving mode.
+    virtual string describe() = 0;
+    virtual ~DriveStrategy() = default; // Virtual destructor for proper cleanup of derived classes.
+};
+
+// Concrete Strategy for Sports vehicles
+// Accelerates hard up to a high top speed.
+class SportDrive : public DriveStrategy {
+public:
+    void drive(MotionState& state) override {
+        state.speed = min(state.speed + 12.0, 250.0);
+        state.distance += state.speed * STEP_HOURS;
+    }
+
+    string describe() override {
+        return "Driving in Sport mode: High speed, sharp handling!";
+    }
+};
+
+// Concrete Strategy for Normal vehicles
+// Accelerates moderately up to a legal cruising speed.
+class NormalDrive : public DriveStrategy {
+public:
+    void drive(MotionState& state) override {
+        state.speed = min(state.speed + 5.0, 120.0);
+        state.distance += state.speed * STEP_HOURS;
+    }
+
+    string describe() override {
+        return "Driving in Normal mode: Balanced speed and comfort.";
+    }
+};
+
+// Concrete Strategy for Passenger vehicles
+// Eases towards a comfortable speed without sudden changes.
+class PassengerDrive : public DriveStrategy {
+public:
+    void drive(MotionState& state) override {
+        state.speed += (90.0 - state.speed) * 0.1;
+        state.distance += state.speed * STEP_HOURS;
+    }
+
+    string describe() override {
+        return "Driving in Passenger mode: Smooth and comfortable ride.";
+    }
+};
+
+// RcuDomain class
+// Quiescent-state-based reclamation. Every reader thread registers a slot. While online, the slot
+// holds the value of the global epoch the reader saw at its last quiescent state; while offline
+// it holds OFFLINE and the reader is ignored. retire() stamps a replaced object with a new epoch,
+// and the object is deleted once every online reader has reported a quiescent state at or after
+// that epoch, because such a reader has dropped any pointer it loaded before the swap. Writers
+// serialize on a mutex; readers never lock.
+class RcuDomain {
+    static const int MAX_READERS = 128;
+    static const uint64_t OFFLINE = UINT64_MAX;
+
+    struct alignas(64) ReaderSlot {
+        atomic<uint64_t> epoch{OFFLINE};
+        atomic<bool> used{false};
+    };
+
+    struct Retired {
+        uint64_t epoch;
+        DriveStrategy* strategy;
+    };
+
+    alignas(64) atomic<uint64_t> globalEpoch;
+    ReaderSlot slots[MAX_READERS];
+    mutex writerMutex;
+    vector<Retired> retired;     // Guarded by writerMutex, oldest first
+    long long reclaimedCount = 0;
+
+    uint64_t oldestReaderEpoch() {
+        uint64_t oldest = OFFLINE;
+        for (ReaderSlot& slot : slots) {
+            oldest = min(oldest, slot.epoch.load());
+        }
+        return oldest;
+    }
+
+    void reclaimLocked() {
+        uint64_t safe = oldestReaderEpoch();
+        size_t freed = 0;
+        while (freed < retired.size() && retired[freed].epoch <= safe) {
+            delete retired[freed].strategy;
+            freed++;
+        }
+        retired.erase(retired.begin(), retired.begin() + freed);
+        reclaimedCount += freed;
+    }
+
+public:
+    // Reader class
+    // Registers the calling thread as a reader for its lifetime. Strategy pointers loaded by the
+    // thread stay valid until its next quiescent() or offline().
+    class Reader {
+        RcuDomain& domain;
+        ReaderSlot* slot;
+
+    public:
+        Reader(RcuDomain& d) : domain(d), slot(nullptr) {
+            for (ReaderSlot& candidate : domain.slots) {
+                bool expected = false;
+                if (candidate.used.compare_exchange_strong(expected, true)) {
+                    slot = &candidate;
+                    break;
+                }
+            }
+            if (slot == nullptr) {
+                throw runtime_error("RcuDomain: too many reader threads");
+            }
+            online();
+        }
+
+        ~Reader() {
+            offline();
+            slot->used.store(false);
+        }
+
+        // Reports that the thread holds no strategy pointer. Call it between batches of reads.
+        void quiescent() {
+            slot->epoch.store(domain.globalEpoch.load(memory_order_acquire), memory_order_release);
+        }
+
+        // Stops the thread from holding back reclamation, e.g. before blocking.
+        void offline() {
+            slot->epoch.store(OFFLINE);
+        }
+
+        // Resumes reading after offline().
+        void online() {
+            slot->epoch.store(domain.globalEpoch.load());
+        }
+    };
+
+    RcuDomain() : globalEpoch(0) {}
+
+    // Deletes everything still retired. No reader may be running.
+    ~RcuDomain() {
+        for (Retired& entry : retired) {
+            delete entry.strategy;
+        }
+    }
+
+    // Hands over an object that readers may still be using; it is deleted after a grace period.
+    void retire(DriveStrategy* strategy) {
+        lock_guard<mutex> lock(writerMutex);
+        retired.push_back({globalEpoch.fetch_add(1) + 1, strategy});
+        reclaimLocked();
+    }
+
+    // Deletes every retired object whose grace period has ended.
+    void reclaim() {
+        lock_guard<mutex> lock(writerMutex);
+        reclaimLocked();
+    }
+
+    long long getReclaimed() {
+        lock_guard<mutex> lock(writerMutex);
+        return reclaimedCount;
+    }
+
+    size_t getPending() {
+        lock_guard<mutex> lock(writerMutex);
+        return retired.size();
+    }
+};
+
+// Vehicle class
+// The strategy pointer is atomic. performDrive() loads it with acquire ordering and calls it, on
+// any thread registered as an RcuDomain reader. setDriveStrategy() publishes the new strategy
+// with an exchange and retires the old one, so it may run concurrently with performDrive().
+// The motion state itself is not shared: each vehicle is driven by one thread at a time.
+class Vehicle {
+protected:
+    atomic<DriveStrategy*> driveStrategy; // Current driving strategy, owned by the vehicle
+    RcuDomain& domain;
+    MotionState state;
+
+public:
+    Vehicle(DriveStrategy* strategy, RcuDomain& d) : driveStrategy(strategy), domain(d) {}
+
+    // Publishes a new driving strategy; the old one is reclaimed once no reader can see it.
+    void setDriveStrategy(DriveStrategy* strategy) {
+        DriveStrategy* old = driveStrategy.exchange(strategy, memory_order_acq_rel);
+        domain.retire(old);
+    }
+
+    // Performs one drive step with the current strategy.
+    void performDrive() {
+        driveStrategy.load(memory_order_acquire)->drive(state);
+    }
+
+    string describe() {
+        return driveStrategy.load(memory_order_acquire)->describe();
+    }
+
+    const MotionState& getState() {
+        return state;
+    }
+
+    // No reader may be using the vehicle any more.
+    virtual ~Vehicle() {
+        delete driveStrategy.load();
+    }
+};
+
+// SportsVehicle class
+// This class represents a specific type of vehicle, the sports car. It initializes
+// the vehicle with the SportDrive strategy by default.
+class SportsVehicle : public Vehicle {
+public:
+    SportsVehicle(RcuDomain& d) : Vehicle(new SportDrive(), d) {}
+};
+
+// The classic unsynchronized vehicle, used as the read-cost baseline. Never swapped concurrently.
+class PlainVehicle {
+    DriveStrategy* driveStrategy;
+    MotionState state;
+
+public:
+    PlainVehicle(DriveStrategy* strategy) : driveStrategy(strategy) {}
+
+    ~PlainVehicle() {
+        delete driveStrategy;
+    }
+
+    // Races with performDrive() on other threads; only safe while nobody is driving.
+    void setDriveStrategy(DriveStrategy* strategy) {
+        delete driveStrategy;
+        driveStrategy = strategy;
+    }
+
+    void performDrive() {
+        driveStrategy->drive(state);
+    }
+
+    const MotionState& getState() {
+        return state;
+    }
+};
+
+static DriveStrategy* randomStrategy(mt19937& rng) {
+    switch (rng() % 3) {
+    case 0: return new SportDrive();
+    case 1: return new NormalDrive();
+    default: return new PassengerDrive();
+    }
+}
+
+static double threadCpuSeconds() {
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// Every driver thread drives its own vehicles for `duration` and reports a quiescent state after
+// each pass. When `swappers` > 0, swapper threads replace random vehicles' strategies in a loop.
+// Returns drive calls per second of driver CPU time, which stays comparable when the swappers
+// share cores with the drivers.
+template <typename V>
+double driveFleet(vector<unique_ptr<V>>& vehicles, RcuDomain* domain, int drivers, int swappers,
+                  chrono::milliseconds duration, long long& swaps) {
+    atomic<bool> stop(false);
+    atomic<long long> calls(0);
+    atomic<long long> cpuNanos(0);
+    atomic<long long> swapCount(0);
+    size_t perDriver = vehicles.size() / drivers;
+    vector<thread> threads;
+    for (int d = 0; d < drivers; d++) {
+        threads.emplace_back([&, d]() {
+            unique_ptr<RcuDomain::Reader> reader(domain ? new RcuDomain::Reader(*domain) : nullptr);
+            double cpuStart = threadCpuSeconds();
+            long long local = 0;
+            while (!stop.load(memory_order_relaxed)) {
+                for (size_t i = d * perDriver; i < (d + 1) * perDriver; i++) {
+                    vehicles[i]->performDrive();
+                }
+                local += perDriver;
+                if (reader) {
+                    reader->quiescent();
+                }
+            }
+            calls.fetch_add(local);
+            cpuNanos.fetch_add((long long)((threadCpuSeconds() - cpuStart) * 1e9));
+        });
+    }
+    for (int s = 0; s < swappers; s++) {
+        threads.emplace_back([&, s]() {
+            mt19937 rng(s + 1);
+            long long local = 0;
+            while (!stop.load(memory_order_relaxed)) {
+                vehicles[rng() % vehicles.size()]->setDriveStrategy(randomStrategy(rng));
+                local++;
+            }
+            swapCount.fetch_add(local);
+        });
+    }
+    this_thread::sleep_for(duration);
+    stop.store(true);
+    for (auto& t : threads) {
+        t.join();
+    }
+    swaps = swapCount.load();
+    return calls.load() / (cpuNanos.load() / 1e9);
+}
+
+void benchmark(int drivers, int vehiclesPerDriver) {
+    cout << fixed << setprecision(1);
+    int count = drivers * vehiclesPerDriver;
+    chrono::milliseconds duration(400);
+    long long swaps = 0;
+
+    vector<unique_ptr<PlainVehicle>> plain;
+    mt19937 rng(7);
+    for (int i = 0; i < count; i++) {
+        plain.emplace_back(new PlainVehicle(randomStrategy(rng)));
+    }
+    double plainRate = driveFleet(plain, nullptr, drivers, 0, duration, swaps);
+    cout << "raw pointer, no swaps:     " << setw(7) << plainRate / 1e6 << " M drives per driver CPU-second" << endl;
+
+    RcuDomain domain;
+    vector<unique_ptr<Vehicle>> vehicles;
+    for (int i = 0; i < count; i++) {
+        vehicles.emplace_back(new Vehicle(randomStrategy(rng), domain));
+    }
+    double quietRate = driveFleet(vehicles, &domain, drivers, 0, duration, swaps);
+    cout << "RCU pointer, no swaps:     " << setw(7) << quietRate / 1e6 << " M drives per driver CPU-second" << endl;
+
+    double swapRate = driveFleet(vehicles, &domain, drivers, 2, duration, swaps);
+    domain.reclaim(); // Every reader is offline now, so everything retired can go
+    cout << "RCU pointer, 2 swappers:   " << setw(7) << swapRate / 1e6 << " M drives per driver CPU-second, "
+         << swaps / (duration.count() / 1000.0) / 1e6 << " M swaps/s, " << domain.getReclaimed()
+         << " strategies reclaimed, " << domain.getPending() << " pending" << endl;
+}
+
+// Main function
+int main() {
+    RcuDomain domain;
+    Vehicle* sportCar = new SportsVehicle(domain);
+
+    {
+        RcuDomain::Reader reader(domain);
+        sportCar->performDrive();
+        cout << sportCar->describe() << endl;
+
+        // Swapped while this thread is a reader: the SportDrive stays alive until it is quiescent
+        sportCar->setDriveStrategy(new NormalDrive());
+        cout << sportCar->describe() << " (retired, not yet reclaimed: " << domain.getPending() << ")" << endl;
+        reader.quiescent();
+        domain.reclaim();
+        cout << "after a quiescent state: " << domain.getPending() << " pending, " << domain.getReclaimed()
+             << " reclaimed" << endl;
+    }
+    delete sportCar;
+
+    cout << "--------------" << endl;
+    unsigned cores = max(1u, thread::hardware_concurrency());
+    benchmark((int)max(2u, min(cores, 8u)), 1000);
+}
@@ -0,0 +1,341 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Strategy Design Pattern with Static Dispatch:
+// The classic Vehicle calls its DriveStrategy through a virtual drive() on a heap pointer. That
+// call cannot be inlined, and a fleet simulation makes it billions of times with strategies that
+// almost never change. This variant keeps the open, virtual Vehicle (fixing its setDriveStrategy
+// leak) and adds two statically dispatched vehicles for the closed set of strategies SportDrive,
+// NormalDrive and PassengerDrive: StaticVehicle<Strategy> fixes the strategy at compile time, and
+// VariantVehicle stores it in a std::variant so it can still be switched at runtime. The variant
+// also has an alternative for any other DriveStrategy, so open strategies keep working there.
+//
+// drive() advances a MotionState by one simulation step instead of printing, so the benchmark
+// measures the dispatch and not the console.
+
+// State a drive strategy advances on every call.
+struct MotionState {
+    double speed = 0;     // km/h
+    double distance = 0;  // km
+};
+
+// Abstract Strategy Class
+// This class defines the interface for various driving strategies. Each specific driving
+// strategy (e.g., SportDrive, NormalDrive) will implement the `drive` method.
+class DriveStrategy {
+public:
+    // Advances the vehicle by one simulation step.
+    virtual void drive(MotionState& state) = 0;
+    // Describes the driving mode.
+    virtual string describe() = 0;
+    virtual ~DriveStrategy() = default; // Virtual destructor for proper cleanup of derived classes.
+};
+
+// Length of one simulation step, in hours.
+static const double STEP_HOURS = 1.0 / 3600;
+
+// Concrete Strategy for Sports vehicles
+// Accelerates hard up to a high top speed. The class is final, so a call on a SportDrive object
+// or reference is resolved at compile time and can be inlined.
+class SportDrive final : public DriveStrategy {
+public:
+    void drive(MotionState& state) override {
+        state.speed = min(state.speed + 12.0, 250.0);
+        state.distance += state.speed * STEP_HOURS;
+    }
+
+    string describe() override {
+        return "Driving in Sport mode: High speed, sharp handling!";
+    }
+};
+
+// Concrete Strategy for Normal vehicles
+// Accelerates moderately up to a legal cruising speed.
+class NormalDrive final : public DriveStrategy {
+public:
+    void drive(MotionState& state) override {
+        state.speed = min(state.speed + 5.0, 120.0);
+        state.distance += state.speed * STEP_HOURS;
+    }
+
+    string describe() override {
+        return "Driving in Normal mode: Balanced speed and comfort.";
+    }
+};
+
+// Concrete Strategy for Passenger vehicles
+// Eases towards a comfortable speed without sudden changes.
+class PassengerDrive final : public DriveStrategy {
+public:
+    void drive(MotionState& state) override {
+        state.speed += (90.0 - state.speed) * 0.1;
+        state.distance += state.speed * STEP_HOURS;
+    }
+
+    string describe() override {
+        return "Driving in Passenger mode: Smooth and comfortable ride.";
+    }
+};
+
+// Concrete Strategy outside the closed set, used to show the open path. Not final on purpose.
+class EcoDrive : public DriveStrategy {
+public:
+    void drive(MotionState& state) override {
+        state.speed = min(state.speed + 2.0, 80.0);
+        state.distance += state.speed * STEP_HOURS;
+    }
+
+    string describe() override {
+        return "Driving in Eco mode: Gentle acceleration, low consumption.";
+    }
+};
+
+// Vehicle class
+// The open, dynamically dispatched vehicle. It owns its strategy, and replacing the strategy now
+// deletes the old one instead of leaking it.
+class Vehicle {
+protected:
+    unique_ptr<DriveStrategy> driveStrategy; // Current driving strategy, owned by the vehicle
+    MotionState state;
+
+public:
+    // Constructor that initializes the vehicle with a specific driving strategy.
+    Vehicle(DriveStrategy* strategy) : driveStrategy(strategy) {}
+
+    // Replaces the current driving strategy, taking ownership of the new one.
+    void setDriveStrategy(DriveStrategy* strategy) {
+        driveStrategy.reset(strategy);
+    }
+
+    // Performs one drive step through a virtual call.
+    void performDrive() {
+        driveStrategy->drive(state);
+    }
+
+    string describe() {
+        return driveStrategy->describe();
+    }
+
+    const MotionState& getState() {
+        return state;
+    }
+
+    virtual ~Vehicle() = default;
+};
+
+// SportsVehicle class
+// This class represents a specific type of vehicle, the sports car. It initializes
+// the vehicle with the SportDrive strategy by default.
+class SportsVehicle : public Vehicle {
+public:
+    SportsVehicle() : Vehicle(new SportDrive()) {}
+};
+
+// StaticVehicle class
+// The strategy is part of the type and stored by value: performDrive() is a direct call that the
+// compiler inlines. Switching strategy means building a vehicle of another type, which
+// withStrategy() does while keeping the motion state.
+template <typename Strategy>
+class StaticVehicle {
+    Strategy driveStrategy;
+    MotionState state;
+
+public:
+    StaticVehicle(MotionState initial = MotionState()) : state(initial) {}
+
+    void performDrive() {
+        driveStrategy.drive(state);
+    }
+
+    string describe() {
+        return driveStrategy.describe();
+    }
+
+    const MotionState& getState() {
+        return state;
+    }
+
+    template <typename Other>
+    StaticVehicle<Other> withStrategy() {
+        return StaticVehicle<Other>(state);
+    }
+};
+
+// VariantVehicle class
+// The strategy is stored by value in a variant over the closed set, plus one alternative holding
+// any other DriveStrategy on the heap. performDrive() switches on the variant index: for the
+// closed set the call inside each case is direct and inlined; only the open alternative goes
+// through the vtable. setDriveStrategy works at runtime for both kinds.
+class VariantVehicle {
+public:
+    typedef variant<SportDrive, NormalDrive, PassengerDrive, unique_ptr<DriveStrategy>> StrategySlot;
+
+private:
+    StrategySlot driveStrategy;
+    MotionState state;
+
+    struct DescribeCall {
+        template <typename Strategy>
+        string operator()(Strategy& strategy) {
+            return strategy.describe();
+        }
+
+        string operator()(unique_ptr<DriveStrategy>& strategy) {
+            return strategy->describe();
+        }
+    };
+
+public:
+    VariantVehicle(StrategySlot strategy) : driveStrategy(move(strategy)) {}
+
+    // Switches to one of the closed-set strategies.
+    template <typename Strategy, typename = enable_if_t<is_base_of_v<DriveStrategy, Strategy>>>
+    void setDriveStrategy(Strategy strategy) {
+        driveStrategy = move(strategy);
+    }
+
+    // Switches to any other strategy, taking ownership of it.
+    void setDriveStrategy(DriveStrategy* strategy) {
+        driveStrategy = unique_ptr<DriveStrategy>(strategy);
+    }
+
+    void performDrive() {
+        switch (driveStrategy.index()) {
+        case 0:
+            get_if<0>(&driveStrategy)->drive(state); // Static type is a final class: no virtual dispatch
+            break;
+        case 1:
+            get_if<1>(&driveStrategy)->drive(state);
+            break;
+        case 2:
+            get_if<2>(&driveStrategy)->drive(state);
+            break;
+        default:
+            (*get_if<3>(&driveStrategy))->drive(state); // Open set: virtual call
+            break;
+        }
+    }
+
+    string describe() {
+        return visit(DescribeCall(), driveStrategy);
+    }
+
+    const MotionState& getState() {
+        return state;
+    }
+};
+
+template <typename F>
+double callsPerSecond(long long calls, F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return calls / chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+template <typename V>
+V& deref(V& vehicle) {
+    return vehicle;
+}
+
+template <typename V>
+V& deref(unique_ptr<V>& vehicle) {
+    return *vehicle;
+}
+
+template <typename Fleet>
+double totalDistance(Fleet& fleet) {
+    double sum = 0;
+    for (auto& vehicle : fleet) {
+        sum += deref(vehicle).getState().distance;
+    }
+    return sum;
+}
+
+// Drives a fleet for `rounds` steps with each mechanism. "Mixed" fleets cycle through the three
+// closed-set strategies, so the virtual call target changes from one vehicle to the next.
+void benchmark(int fleetSize, int rounds) {
+    long long calls = (long long)fleetSize * rounds;
+    double checksum = 0;
+    cout << fixed << setprecision(1);
+
+    vector<unique_ptr<Vehicle>> mixedVirtual; // Heap objects, as the classic design allocates them
+    vector<VariantVehicle> mixedVariant;
+    vector<VariantVehicle> openVariant;
+    for (int i = 0; i < fleetSize; i++) {
+        switch (i % 3) {
+        case 0:
+            mixedVirtual.emplace_back(new Vehicle(new SportDrive()));
+            mixedVariant.emplace_back(SportDrive());
+            break;
+        case 1:
+            mixedVirtual.emplace_back(new Vehicle(new NormalDrive()));
+            mixedVariant.emplace_back(NormalDrive());
+            break;
+        default:
+            mixedVirtual.emplace_back(new Vehicle(new PassengerDrive()));
+            mixedVariant.emplace_back(PassengerDrive());
+            break;
+        }
+        openVariant.emplace_back(unique_ptr<DriveStrategy>(new EcoDrive()));
+    }
+    vector<unique_ptr<Vehicle>> sportVirtual;
+    vector<StaticVehicle<SportDrive>> sportStatic(fleetSize);
+    vector<VariantVehicle> sportVariant;
+    for (int i = 0; i < fleetSize; i++) {
+        sportVirtual.emplace_back(new SportsVehicle());
+        sportVariant.emplace_back(SportDrive());
+    }
+
+    auto run = [&](const char* label, auto& fleet) {
+        double rate = callsPerSecond(calls, [&]() {
+            for (int r = 0; r < rounds; r++) {
+                for (auto& vehicle : fleet) {
+                    deref(vehicle).performDrive();
+                }
+            }
+        });
+        checksum += totalDistance(fleet);
+        cout << label << setw(8) << rate / 1e6 << " M calls/s" << endl;
+    };
+
+    run("mixed fleet,  virtual Vehicle           ", mixedVirtual);
+    run("mixed fleet,  VariantVehicle            ", mixedVariant);
+    run("sport fleet,  virtual Vehicle           ", sportVirtual);
+    run("sport fleet,  VariantVehicle            ", sportVariant);
+    run("sport fleet,  StaticVehicle<SportDrive> ", sportStatic);
+    run("eco fleet,    VariantVehicle open path  ", openVariant);
+    cout << "(checksum " << checksum << " km)" << endl;
+}
+
+// Main function
+int main() {
+    // The classic vehicle, now without the leak when the strategy is replaced
+    Vehicle* sportCar = new SportsVehicle();
+    sportCar->performDrive();
+    cout << sportCar->describe() << endl;
+    sportCar->setDriveStrategy(new NormalDrive()); // The SportDrive is deleted here
+    cout << sportCar->describe() << endl;
+    delete sportCar;
+
+    // Compile-time strategy, switched by building a vehicle of another type
+    StaticVehicle<SportDrive> track;
+    for (int i = 0; i < 30; i++) {
+        track.performDrive();
+    }
+    StaticVehicle<PassengerDrive> cruise = track.withStrategy<PassengerDrive>();
+    for (int i = 0; i < 30; i++) {
+        cruise.performDrive();
+    }
+    cout << cruise.describe() << " Speed " << cruise.getState().speed << " km/h" << endl;
+
+    // Runtime switching within the closed set and out to an open strategy
+    VariantVehicle car{SportDrive()};
+    cout << car.describe() << endl;
+    car.setDriveStrategy(PassengerDrive());
+    cout << car.describe() << endl;
+    car.setDriveStrategy(new EcoDrive());
+    cout << car.describe() << endl;
+
+    cout << "--------------" << endl;
+    benchmark(3000, 20000);
+}
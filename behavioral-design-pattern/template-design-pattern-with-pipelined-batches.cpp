@@ -0,0 +1,497 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Template Method Design Pattern with Pipelined Batches:
+// IPayment::sendMoney() runs validateRequest, calculateFees, debitAmount and creditAmount one after
+// another, for one payment, on the caller's thread. This variant keeps that four-step contract and
+// adds a PipelinedPaymentEngine that runs each step as a pipeline stage on its own thread. Payments
+// travel between the stages in batches through bounded queues, so every stage works on a batch
+// while the others work on the batches before and after it.
+//
+// Every stage handles the batches in submission order, so each step sees each account's payments
+// in the order they were submitted. On top of that the debit stage waits before debiting an account
+// that still has a credit from an earlier payment in flight, so the ledger ends exactly as the
+// serial sendMoney() loop leaves it.
+
+// Ledger class
+// Account balances in cents. The debit and credit stages touch the ledger from different threads,
+// so the balances are atomics.
+class Ledger {
+    vector<atomic<long long>> balances;
+
+public:
+    Ledger(size_t accounts, long long openingBalance) : balances(accounts) {
+        for (auto& balance : balances) {
+            balance.store(openingBalance, memory_order_relaxed);
+        }
+    }
+
+    size_t size() {
+        return balances.size();
+    }
+
+    // Removes `amount` from the account if it holds enough; returns false otherwise.
+    bool debit(int account, long long amount) {
+        long long balance = balances[account].load(memory_order_relaxed);
+        while (balance >= amount) {
+            if (balances[account].compare_exchange_weak(balance, balance - amount, memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void credit(int account, long long amount) {
+        balances[account].fetch_add(amount, memory_order_relaxed);
+    }
+
+    long long balance(int account) {
+        return balances[account].load(memory_order_relaxed);
+    }
+};
+
+// Abstract Base Class defining the template method
+// A payment now carries its accounts and amount. A step can reject the payment, and the remaining
+// steps are then skipped.
+class IPayment {
+protected:
+    Ledger* ledger;
+
+public:
+    static const int STEPS = 4;
+
+    int fromAccount;
+    int toAccount;
+    long long amount;        // Cents
+    long long fee = 0;       // Cents, set by calculateFees
+    const char* rejection = nullptr; // Reason, set by the step that rejected the payment
+
+    IPayment(Ledger* l, int from, int to, long long amt) : ledger(l), fromAccount(from), toAccount(to), amount(amt) {}
+
+    // Template method defining the skeleton of the algorithm
+    // The 'sendMoney' method is final, ensuring it can't be overridden by subclasses.
+    // It calls the common steps in a fixed order.
+    virtual void sendMoney() final {
+        for (int step = 0; step < STEPS; step++) {
+            runStep(step);
+        }
+    }
+
+    // Runs one step of the skeleton: 0 validate, 1 fees, 2 debit, 3 credit. The pipeline calls
+    // this from its stages, so both paths share the same order and the same skipping rule.
+    void runStep(int step) {
+        if (rejected()) {
+            return;
+        }
+        switch (step) {
+        case 0: validateRequest(); break; // Step 1
+        case 1: calculateFees(); break;   // Step 2
+        case 2: debitAmount(); break;     // Step 3
+        default: creditAmount(); break;   // Step 4
+        }
+    }
+
+    bool rejected() {
+        return rejection != nullptr;
+    }
+
+    // These are the abstract methods that must be implemented by subclasses
+    virtual void validateRequest() = 0;
+    virtual void calculateFees() = 0;
+    virtual void debitAmount() = 0;
+    virtual void creditAmount() = 0;
+
+    virtual ~IPayment() = default;
+
+protected:
+    void validateAccounts() {
+        if (amount <= 0) {
+            rejection = "amount must be positive";
+        } else if (fromAccount < 0 || toAccount < 0 || (size_t)fromAccount >= ledger->size() ||
+                   (size_t)toAccount >= ledger->size()) {
+            rejection = "unknown account";
+        } else if (fromAccount == toAccount) {
+            rejection = "cannot pay the same account";
+        }
+    }
+};
+
+// Subclass for sending money to a friend
+// Free of charge: the friend receives the whole amount.
+class PayToFriend : public IPayment {
+public:
+    PayToFriend(Ledger* l, int from, int to, long long amt) : IPayment(l, from, to, amt) {}
+
+    void validateRequest() override {
+        validateAccounts();
+    }
+
+    void calculateFees() override {
+        fee = 0;
+    }
+
+    void debitAmount() override {
+        if (!ledger->debit(fromAccount, amount)) {
+            rejection = "insufficient funds";
+        }
+    }
+
+    void creditAmount() override {
+        ledger->credit(toAccount, amount);
+    }
+};
+
+// Subclass for sending money to a merchant
+// The merchant pays a 1.5% + 30 cent fee out of the amount it receives.
+class PayToMerch : public IPayment {
+public:
+    PayToMerch(Ledger* l, int from, int to, long long amt) : IPayment(l, from, to, amt) {}
+
+    void validateRequest() override {
+        validateAccounts();
+        if (!rejected() && amount <= 30) {
+            rejection = "amount does not cover the merchant fee";
+        }
+    }
+
+    void calculateFees() override {
+        fee = min(amount * 15 / 1000 + 30, amount);
+    }
+
+    void debitAmount() override {
+        if (!ledger->debit(fromAccount, amount)) {
+            rejection = "insufficient funds";
+        }
+    }
+
+    void creditAmount() override {
+        ledger->credit(toAccount, amount - fee);
+    }
+};
+
+// BoundedQueue class
+// A blocking FIFO with a fixed capacity: push() waits while it is full and pop() while it is empty.
+// After close(), pop() drains what is left and then returns false. It also records its depth at
+// every push.
+template <typename T>
+class BoundedQueue {
+    mutex lock;
+    condition_variable notFull;
+    condition_variable notEmpty;
+    deque<T> items;
+    size_t capacity;
+    bool closed = false;
+    long long pushes = 0;
+    long long depthSum = 0;
+    size_t maxDepth = 0;
+
+public:
+    BoundedQueue(size_t cap) : capacity(max<size_t>(cap, 1)) {}
+
+    void push(T item) {
+        unique_lock<mutex> guard(lock);
+        notFull.wait(guard, [&]() { return items.size() < capacity; });
+        items.push_back(move(item));
+        pushes++;
+        depthSum += items.size();
+        maxDepth = max(maxDepth, items.size());
+        notEmpty.notify_one();
+    }
+
+    bool pop(T& item) {
+        unique_lock<mutex> guard(lock);
+        notEmpty.wait(guard, [&]() { return closed || !items.empty(); });
+        if (items.empty()) {
+            return false;
+        }
+        item = move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    void close() {
+        lock_guard<mutex> guard(lock);
+        closed = true;
+        notEmpty.notify_all();
+    }
+
+    size_t depth() {
+        lock_guard<mutex> guard(lock);
+        return items.size();
+    }
+
+    // Average and largest depth seen right after a push.
+    pair<double, size_t> depthStats() {
+        lock_guard<mutex> guard(lock);
+        return {pushes ? (double)depthSum / pushes : 0.0, maxDepth};
+    }
+};
+
+// Throughput and queue depth of one pipeline stage.
+struct StageStats {
+    long long payments = 0;
+    long long batches = 0;
+    double busySeconds = 0;         // Time spent running steps
+    size_t queueDepth = 0;          // Batches waiting in front of the stage right now
+    double averageQueueDepth = 0;   // Batches waiting, sampled at every push
+    size_t maxQueueDepth = 0;
+    long long orderingWaits = 0;    // Debit stage only: waits for an earlier credit to the account
+};
+
+// PipelinedPaymentEngine class
+// One thread per step of sendMoney(), each fed by a bounded queue of payment batches. submit()
+// collects payments into a batch for the validate stage; each stage runs its step on every payment
+// of a batch and passes the batch on. The engine does not own the payments.
+class PipelinedPaymentEngine {
+    typedef vector<IPayment*> Batch;
+
+    struct Stage {
+        BoundedQueue<Batch> input;
+        thread worker;
+        atomic<long long> payments{0};
+        atomic<long long> batches{0};
+        atomic<long long> busyNanos{0};
+        atomic<long long> waits{0};
+
+        Stage(size_t capacity) : input(capacity) {}
+    };
+
+    size_t batchSize;
+    vector<unique_ptr<Stage>> stages;
+    Batch pending; // Batch being filled by submit()
+
+    // Credits that have passed the debit stage but not the credit stage yet, per account
+    vector<atomic<int>> creditsInFlight;
+
+    mutex doneLock;
+    condition_variable doneChanged;
+    long long submitted = 0;
+    long long completed = 0;
+
+    void forward(int step, Batch& batch) {
+        if (step + 1 < IPayment::STEPS) {
+            stages[step + 1]->input.push(move(batch));
+        } else {
+            lock_guard<mutex> guard(doneLock);
+            completed += batch.size();
+            doneChanged.notify_all();
+        }
+        batch = Batch();
+    }
+
+    // Runs the debit step over a batch. A payment whose account still has an earlier credit in
+    // flight waits for it; the payments debited so far are sent ahead first, since that credit may
+    // be one of them.
+    void debitBatch(Batch& batch) {
+        Batch done;
+        done.reserve(batch.size());
+        for (IPayment* payment : batch) {
+            if (!payment->rejected() && creditsInFlight[payment->fromAccount].load(memory_order_acquire) > 0) {
+                if (!done.empty()) {
+                    forward(2, done);
+                }
+                stages[2]->waits++;
+                while (creditsInFlight[payment->fromAccount].load(memory_order_acquire) > 0) {
+                    this_thread::yield();
+                }
+            }
+            payment->runStep(2);
+            if (!payment->rejected()) {
+                creditsInFlight[payment->toAccount].fetch_add(1, memory_order_relaxed);
+            }
+            done.push_back(payment);
+        }
+        batch = move(done);
+    }
+
+    void creditBatch(Batch& batch) {
+        for (IPayment* payment : batch) {
+            bool inFlight = !payment->rejected();
+            payment->runStep(3);
+            if (inFlight) {
+                creditsInFlight[payment->toAccount].fetch_sub(1, memory_order_release);
+            }
+        }
+    }
+
+    void runStage(int step) {
+        Stage& stage = *stages[step];
+        Batch batch;
+        while (stage.input.pop(batch)) {
+            auto start = chrono::steady_clock::now();
+            long long size = batch.size();
+            if (step == 2) {
+                debitBatch(batch);
+            } else if (step == 3) {
+                creditBatch(batch);
+            } else {
+                for (IPayment* payment : batch) {
+                    payment->runStep(step);
+                }
+            }
+            stage.busyNanos += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+            stage.payments += size;
+            stage.batches++;
+            if (!batch.empty()) {
+                forward(step, batch);
+            }
+        }
+    }
+
+public:
+    PipelinedPaymentEngine(Ledger* ledger, size_t batch = 256, size_t queueCapacity = 64)
+        : batchSize(max<size_t>(batch, 1)), creditsInFlight(ledger->size()) {
+        for (int step = 0; step < IPayment::STEPS; step++) {
+            stages.emplace_back(new Stage(queueCapacity));
+        }
+        for (int step = 0; step < IPayment::STEPS; step++) {
+            stages[step]->worker = thread(&PipelinedPaymentEngine::runStage, this, step);
+        }
+        pending.reserve(batchSize);
+    }
+
+    ~PipelinedPaymentEngine() {
+        flush();
+        for (int step = 0; step < IPayment::STEPS; step++) {
+            stages[step]->input.close();
+            stages[step]->worker.join(); // Earlier stages have forwarded everything by now
+        }
+    }
+
+    // Queues a payment. It enters the pipeline when its batch is full or on flush().
+    void submit(IPayment* payment) {
+        pending.push_back(payment);
+        if (pending.size() >= batchSize) {
+            flush();
+        }
+    }
+
+    // Sends the partly filled batch into the pipeline.
+    void flush() {
+        if (pending.empty()) {
+            return;
+        }
+        {
+            lock_guard<mutex> guard(doneLock);
+            submitted += pending.size();
+        }
+        stages[0]->input.push(move(pending));
+        pending = Batch();
+        pending.reserve(batchSize);
+    }
+
+    // Flushes and waits until every submitted payment has been through all four steps.
+    void drain() {
+        flush();
+        unique_lock<mutex> guard(doneLock);
+        doneChanged.wait(guard, [&]() { return completed == submitted; });
+    }
+
+    StageStats stageStats(int step) {
+        Stage& stage = *stages[step];
+        StageStats stats;
+        stats.payments = stage.payments.load();
+        stats.batches = stage.batches.load();
+        stats.busySeconds = stage.busyNanos.load() / 1e9;
+        stats.orderingWaits = stage.waits.load();
+        stats.queueDepth = stage.input.depth();
+        tie(stats.averageQueueDepth, stats.maxQueueDepth) = stage.input.depthStats();
+        return stats;
+    }
+};
+
+static const char* STEP_NAMES[IPayment::STEPS] = {"validateRequest", "calculateFees", "debitAmount", "creditAmount"};
+
+// Builds the same random payment stream twice, one copy per ledger.
+void makePayments(Ledger* ledger, size_t count, int accounts, vector<unique_ptr<IPayment>>& payments) {
+    mt19937 rng(7);
+    payments.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        int from = rng() % accounts;
+        int to = rng() % accounts;
+        long long amount = 100 + rng() % 20000;
+        if (rng() % 4 == 0) {
+            payments.emplace_back(new PayToMerch(ledger, from, to, amount));
+        } else {
+            payments.emplace_back(new PayToFriend(ledger, from, to, amount));
+        }
+    }
+}
+
+// Runs `count` payments between `accounts` accounts through a serial sendMoney() loop and through
+// the pipeline, and checks that both leave the same ledger.
+void benchmark(size_t count, int accounts) {
+    Ledger serialLedger(accounts, 50000), pipelineLedger(accounts, 50000);
+    vector<unique_ptr<IPayment>> serialPayments, pipelinePayments;
+    makePayments(&serialLedger, count, accounts, serialPayments);
+    makePayments(&pipelineLedger, count, accounts, pipelinePayments);
+
+    auto start = chrono::steady_clock::now();
+    for (auto& payment : serialPayments) {
+        payment->sendMoney();
+    }
+    double serialSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    PipelinedPaymentEngine engine(&pipelineLedger);
+    start = chrono::steady_clock::now();
+    for (auto& payment : pipelinePayments) {
+        engine.submit(payment.get());
+    }
+    engine.drain();
+    double pipelineSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    bool same = true;
+    long long rejected = 0;
+    for (int account = 0; account < accounts; account++) {
+        same = same && serialLedger.balance(account) == pipelineLedger.balance(account);
+    }
+    for (size_t i = 0; i < count; i++) {
+        same = same && serialPayments[i]->rejected() == pipelinePayments[i]->rejected();
+        rejected += serialPayments[i]->rejected();
+    }
+
+    cout << fixed << setprecision(2);
+    cout << count << " payments, " << accounts << " accounts, " << rejected << " rejected, "
+         << thread::hardware_concurrency() << " hardware threads" << endl;
+    cout << "serial sendMoney() " << setw(8) << count / serialSeconds / 1e6 << " M payments/s" << endl;
+    cout << "pipelined engine   " << setw(8) << count / pipelineSeconds / 1e6 << " M payments/s, ledgers "
+         << (same ? "match" : "DIFFER") << endl;
+    for (int step = 0; step < IPayment::STEPS; step++) {
+        StageStats stats = engine.stageStats(step);
+        cout << "  " << left << setw(16) << STEP_NAMES[step] << right << setw(8)
+             << stats.payments / stats.busySeconds / 1e6 << " M payments/s busy, " << stats.batches
+             << " batches, queue depth avg " << stats.averageQueueDepth << " max " << stats.maxQueueDepth;
+        if (step == 2) {
+            cout << ", " << stats.orderingWaits << " ordering waits";
+        }
+        cout << endl;
+    }
+}
+
+int main() {
+    Ledger ledger(4, 10000);
+    vector<unique_ptr<IPayment>> payments;
+    payments.emplace_back(new PayToFriend(&ledger, 0, 1, 2500));
+    payments.emplace_back(new PayToMerch(&ledger, 1, 3, 12000)); // Needs the 2500 from the first payment
+    payments.emplace_back(new PayToFriend(&ledger, 2, 2, 500));
+    payments.emplace_back(new PayToFriend(&ledger, 0, 2, 9000));
+
+    {
+        PipelinedPaymentEngine engine(&ledger, 2);
+        for (auto& payment : payments) {
+            engine.submit(payment.get());
+        }
+        engine.drain();
+    }
+    for (auto& payment : payments) {
+        cout << "Payment of " << payment->amount << " from " << payment->fromAccount << " to " << payment->toAccount
+             << ": " << (payment->rejected() ? payment->rejection : "done") << ", fee " << payment->fee << endl;
+    }
+    for (int account = 0; account < 4; account++) {
+        cout << "Account " << account << " balance " << ledger.balance(account) << endl;
+    }
+
+    cout << "----------------------" << endl;
+    benchmark(2000000, 10000);
+}
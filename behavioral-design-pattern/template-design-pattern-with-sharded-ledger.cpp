@@ -0,0 +1,353 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Template Method Design Pattern with a Sharded Ledger:
+// PayToFriend and PayToMerch have debit and credit steps but nothing behind them. This variant
+// gives them a ShardedLedger that many threads can pay through at once. Accounts are spread over
+// shards by lock striping: each shard has its own mutex and keeps the balances of its accounts
+// together, so payments between unrelated accounts rarely meet on a lock. A transfer locks the
+// payer's and the payee's shards in ascending shard order, which makes it atomic and rules out
+// deadlock: two transfers can never each hold the lock the other one is waiting for.
+
+// ShardedLedger class
+// Account `a` lives in shard a % shardCount, at index a / shardCount of that shard's balances.
+// Every lock acquisition first tries the lock; one that finds it held counts as contended.
+class ShardedLedger {
+    struct alignas(64) Shard {
+        mutex lock;
+        vector<long long> balances; // Cents
+        long long acquisitions = 0; // Updated while holding the lock
+        long long contended = 0;
+    };
+
+    vector<unique_ptr<Shard>> shards;
+    size_t accounts;
+
+    size_t shardOf(int account) {
+        return account % shards.size();
+    }
+
+    long long& balanceOf(int account) {
+        return shards[shardOf(account)]->balances[account / shards.size()];
+    }
+
+    void lockShard(size_t shard) {
+        Shard& s = *shards[shard];
+        bool contended = !s.lock.try_lock();
+        if (contended) {
+            s.lock.lock();
+        }
+        s.acquisitions++;
+        s.contended += contended;
+    }
+
+public:
+    ShardedLedger(size_t accountCount, size_t shardCount, long long openingBalance) : accounts(accountCount) {
+        shardCount = max<size_t>(shardCount, 1);
+        for (size_t s = 0; s < shardCount; s++) {
+            shards.emplace_back(new Shard());
+            shards.back()->balances.assign((accountCount + shardCount - 1 - s) / shardCount, openingBalance);
+        }
+    }
+
+    size_t size() {
+        return accounts;
+    }
+
+    // Transfer class
+    // Holds the locks of a payer's and a payee's shards, taken in ascending shard order, for as long
+    // as it lives. Balances change only through debit() and credit(), so other threads see either
+    // none or all of a transfer.
+    class Transfer {
+        ShardedLedger* ledger;
+        int fromAccount;
+        int toAccount;
+        size_t first;
+        size_t second;
+
+    public:
+        Transfer(ShardedLedger* l, int from, int to) : ledger(l), fromAccount(from), toAccount(to) {
+            first = min(ledger->shardOf(from), ledger->shardOf(to));
+            second = max(ledger->shardOf(from), ledger->shardOf(to));
+            ledger->lockShard(first);
+            if (second != first) {
+                ledger->lockShard(second);
+            }
+        }
+
+        Transfer(const Transfer&) = delete;
+        Transfer& operator=(const Transfer&) = delete;
+
+        // Takes `amount` from the payer if the payer holds enough; returns false otherwise.
+        bool debit(long long amount) {
+            long long& balance = ledger->balanceOf(fromAccount);
+            if (balance < amount) {
+                return false;
+            }
+            balance -= amount;
+            return true;
+        }
+
+        void credit(long long amount) {
+            ledger->balanceOf(toAccount) += amount;
+        }
+
+        ~Transfer() {
+            if (second != first) {
+                ledger->shards[second]->lock.unlock();
+            }
+            ledger->shards[first]->lock.unlock();
+        }
+    };
+
+    long long balance(int account) {
+        lock_guard<mutex> guard(shards[shardOf(account)]->lock);
+        return balanceOf(account);
+    }
+
+    long long totalBalance() {
+        long long total = 0;
+        for (auto& shard : shards) {
+            lock_guard<mutex> guard(shard->lock);
+            total = accumulate(shard->balances.begin(), shard->balances.end(), total);
+        }
+        return total;
+    }
+
+    // Lock acquisitions and how many of them found the lock held, summed over the shards.
+    pair<long long, long long> lockStats() {
+        long long acquisitions = 0, contended = 0;
+        for (auto& shard : shards) {
+            lock_guard<mutex> guard(shard->lock);
+            acquisitions += shard->acquisitions;
+            contended += shard->contended;
+        }
+        return {acquisitions, contended};
+    }
+};
+
+// Abstract Base Class defining the template method
+// A payment carries its accounts and amount. Steps can reject it, and the rest are then skipped.
+// debitAmount opens a ShardedLedger::Transfer and creditAmount completes it: sendMoney() is final
+// and runs the two steps back to back on one thread, so the debit and the credit form one atomic
+// transfer.
+class IPayment {
+protected:
+    ShardedLedger* ledger;
+    optional<ShardedLedger::Transfer> transfer; // Open between debitAmount and creditAmount
+
+public:
+    int fromAccount;
+    int toAccount;
+    long long amount;        // Cents
+    long long fee = 0;       // Cents, set by calculateFees
+    const char* rejection = nullptr; // Reason, set by the step that rejected the payment
+
+    IPayment(ShardedLedger* l, int from, int to, long long amt) : ledger(l), fromAccount(from), toAccount(to), amount(amt) {}
+
+    // Template method defining the skeleton of the algorithm
+    // The 'sendMoney' method is final, ensuring it can't be overridden by subclasses.
+    // It calls the common steps in a fixed order.
+    virtual void sendMoney() final {
+        validateRequest();       // Step 1
+        if (!rejected()) {
+            calculateFees();     // Step 2
+        }
+        if (!rejected()) {
+            debitAmount();       // Step 3
+        }
+        if (!rejected()) {
+            creditAmount();      // Step 4
+        }
+        transfer.reset();        // Releases the shard locks if a step left them held
+    }
+
+    bool rejected() {
+        return rejection != nullptr;
+    }
+
+    // These are the abstract methods that must be implemented by subclasses
+    virtual void validateRequest() = 0;
+    virtual void calculateFees() = 0;
+    virtual void debitAmount() = 0;
+    virtual void creditAmount() = 0;
+
+    virtual ~IPayment() = default;
+
+protected:
+    void validateAccounts() {
+        if (amount <= 0) {
+            rejection = "amount must be positive";
+        } else if (fromAccount < 0 || toAccount < 0 || (size_t)fromAccount >= ledger->size() ||
+                   (size_t)toAccount >= ledger->size()) {
+            rejection = "unknown account";
+        } else if (fromAccount == toAccount) {
+            rejection = "cannot pay the same account";
+        }
+    }
+
+    // Locks both accounts and takes `total` from the payer, or rejects the payment.
+    void openTransfer(long long total) {
+        transfer.emplace(ledger, fromAccount, toAccount);
+        if (!transfer->debit(total)) {
+            rejection = "insufficient funds";
+            transfer.reset();
+        }
+    }
+
+    // Gives `credited` to the payee and releases the locks.
+    void completeTransfer(long long credited) {
+        transfer->credit(credited);
+        transfer.reset();
+    }
+};
+
+// Subclass for sending money to a friend
+// Free of charge: the friend receives the whole amount.
+class PayToFriend : public IPayment {
+public:
+    PayToFriend(ShardedLedger* l, int from, int to, long long amt) : IPayment(l, from, to, amt) {}
+
+    void validateRequest() override {
+        validateAccounts();
+    }
+
+    void calculateFees() override {
+        fee = 0;
+    }
+
+    void debitAmount() override {
+        openTransfer(amount);
+    }
+
+    void creditAmount() override {
+        completeTransfer(amount);
+    }
+};
+
+// Subclass for sending money to a merchant
+// The merchant pays a 1.5% + 30 cent fee out of the amount it receives.
+class PayToMerch : public IPayment {
+public:
+    PayToMerch(ShardedLedger* l, int from, int to, long long amt) : IPayment(l, from, to, amt) {}
+
+    void validateRequest() override {
+        validateAccounts();
+        if (!rejected() && amount <= 30) {
+            rejection = "amount does not cover the merchant fee";
+        }
+    }
+
+    void calculateFees() override {
+        fee = min(amount * 15 / 1000 + 30, amount);
+    }
+
+    void debitAmount() override {
+        openTransfer(amount);
+    }
+
+    void creditAmount() override {
+        completeTransfer(amount - fee);
+    }
+};
+
+// Workload of the benchmark: uniform picks both accounts at random; hot sends `hotShare` of the
+// payments to one of a few merchant accounts.
+struct Workload {
+    const char* name;
+    double hotShare;
+    int hotAccounts;
+};
+
+// Runs `perThread` payments on each of `threads` threads over a fresh ledger and prints transfers
+// per second and lock contention. Money is conserved: opening total minus collected fees.
+void runWorkload(Workload workload, int threads, size_t perThread, size_t accounts, size_t shardCount) {
+    const long long OPENING = 100000;
+    ShardedLedger ledger(accounts, shardCount, OPENING);
+    vector<vector<unique_ptr<IPayment>>> payments(threads);
+    for (int t = 0; t < threads; t++) {
+        mt19937 rng(t + 1);
+        uniform_real_distribution<double> unit(0, 1);
+        payments[t].reserve(perThread);
+        for (size_t i = 0; i < perThread; i++) {
+            int from = rng() % accounts;
+            long long amount = 100 + rng() % 5000;
+            if (unit(rng) < workload.hotShare) {
+                int merchant = rng() % workload.hotAccounts; // Hot merchants are the lowest accounts
+                payments[t].emplace_back(new PayToMerch(&ledger, from, merchant, amount));
+            } else {
+                payments[t].emplace_back(new PayToFriend(&ledger, from, rng() % accounts, amount));
+            }
+        }
+    }
+
+    auto start = chrono::steady_clock::now();
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&payments, t]() {
+            for (auto& payment : payments[t]) {
+                payment->sendMoney();
+            }
+        });
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    long long fees = 0;
+    for (auto& list : payments) {
+        for (auto& payment : list) {
+            fees += payment->rejected() ? 0 : payment->fee;
+        }
+    }
+    pair<long long, long long> locks = ledger.lockStats();
+    bool conserved = ledger.totalBalance() == OPENING * (long long)accounts - fees;
+    cout << "  " << left << setw(8) << workload.name << right << setw(3) << threads << " threads: " << setw(7)
+         << threads * perThread / seconds / 1e6 << " M transfers/s, contention " << setw(6)
+         << 100.0 * locks.second / max(locks.first, 1LL) << "%, money " << (conserved ? "conserved" : "LOST") << endl;
+}
+
+void benchmark(size_t perThread, size_t accounts, size_t shardCount) {
+    cout << accounts << " accounts in " << shardCount << " shards, " << perThread << " transfers per thread, "
+         << thread::hardware_concurrency() << " hardware threads" << endl;
+    cout << fixed << setprecision(2);
+    Workload workloads[] = {{"uniform", 0.0, 1}, {"hot", 0.9, 4}};
+    for (Workload workload : workloads) {
+        for (int threads = 1; threads <= 8; threads *= 2) {
+            runWorkload(workload, threads, perThread, accounts, shardCount);
+        }
+    }
+}
+
+int main() {
+    ShardedLedger ledger(4, 2, 10000);
+
+    // Create an instance of PayToFriend
+    IPayment* payToFriend = new PayToFriend(&ledger, 0, 1, 2500);
+    // Calling the template method to execute the payment process
+    payToFriend->sendMoney();
+    cout << "Pay to friend: " << (payToFriend->rejected() ? payToFriend->rejection : "done") << endl;
+
+    cout << "----------------------" << endl;
+
+    // Create an instance of PayToMerch
+    IPayment* payToMerch = new PayToMerch(&ledger, 1, 3, 20000);
+    // Calling the template method to execute the payment process
+    payToMerch->sendMoney();
+    cout << "Pay to Merch: " << (payToMerch->rejected() ? payToMerch->rejection : "done") << endl;
+    payToMerch->amount = 12000;
+    payToMerch->rejection = nullptr;
+    payToMerch->sendMoney();
+    cout << "Pay to Merch: " << (payToMerch->rejected() ? payToMerch->rejection : "done") << ", fee "
+         << payToMerch->fee << endl;
+
+    for (int account = 0; account < 4; account++) {
+        cout << "Account " << account << " balance " << ledger.balance(account) << endl;
+    }
+    delete payToFriend;
+    delete payToMerch;
+
+    cout << "----------------------" << endl;
+    benchmark(250000, 1000000, 256);
+}
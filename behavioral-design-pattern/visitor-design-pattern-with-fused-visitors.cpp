@@ -0,0 +1,265 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Visitor Design Pattern with Fused Visitors:
+// Running the pricing visitor and then the maintenance visitor walks the rooms twice, and with
+// many visitors over a large inventory every extra pass is another trip through memory. This
+// variant adds a CompositeRoomVisitor that holds N visitors and is itself a RoomVisitor: each
+// room's accept() dispatches on the room type once, and the composite's handler for that type then
+// calls the same handler of every visitor while the room is still in cache. The visitors need no
+// changes.
+
+class SingleRoom; // Forward declaration
+class DoubleRoom; // Forward declaration
+class DeluxRoom;  // Forward declaration
+
+// Abstract Visitor class defining the visit methods for different room types
+class RoomVisitor {
+public:
+    virtual void visit(SingleRoom *singleRoom) = 0; // Visit single room
+    virtual void visit(DoubleRoom *doubleRoom) = 0; // Visit double room
+    virtual void visit(DeluxRoom *deluxRoom) = 0;   // Visit deluxe room
+    virtual ~RoomVisitor() = default;
+};
+
+// Abstract Element class with the accept method
+class RoomElement {
+public:
+    virtual void accept(RoomVisitor *visitor) = 0; // Accept visitor
+    virtual ~RoomElement() = default;
+};
+
+// Concrete Element class for a single room
+class SingleRoom : public RoomElement {
+public:
+    int roomPrice = 1000; // Price of a single room
+    void accept(RoomVisitor *visitor) override {
+        visitor->visit(this); // Accept a visitor and call its visit method
+    }
+};
+
+// Concrete Element class for a double room
+class DoubleRoom : public RoomElement {
+public:
+    int roomPrice = 2000; // Price of a double room
+    void accept(RoomVisitor *visitor) override {
+        visitor->visit(this); // Accept a visitor and call its visit method
+    }
+};
+
+// Concrete Element class for a deluxe room
+class DeluxRoom : public RoomElement {
+public:
+    int roomPrice = 3000; // Price of a deluxe room
+    void accept(RoomVisitor *visitor) override {
+        visitor->visit(this); // Accept a visitor and call its visit method
+    }
+};
+
+// Concrete Visitor class for calculating the pricing of rooms
+class RoomPricingVisitor : public RoomVisitor {
+public:
+    /**
+     * Prints the price of a single room to the console.
+     * @param singleRoom Pointer to a SingleRoom object
+     */
+    void visit(SingleRoom *singleRoom) override {
+        cout << "Price for this single room is " << singleRoom->roomPrice << endl;
+    }
+
+    /**
+     * Prints the price of a double room to the console.
+     * @param doubleRoom Pointer to a DoubleRoom object
+     */
+    void visit(DoubleRoom *doubleRoom) override {
+        cout << "Price for this double room is " << doubleRoom->roomPrice << endl;
+    }
+
+    /**
+     * Prints the price of a deluxe room to the console.
+     * @param deluxRoom Pointer to a DeluxRoom object
+     */
+    void visit(DeluxRoom *deluxRoom) override {
+        cout << "Price for this deluxe room is " << deluxRoom->roomPrice << endl;
+    }
+};
+
+// Concrete Visitor class for performing maintenance on rooms
+class RoomMaintainenceVisitor : public RoomVisitor {
+public:
+    void visit(SingleRoom *singleRoom) override {
+        cout << "Maintenance for this single room" << endl;
+    }
+    void visit(DoubleRoom *doubleRoom) override {
+        cout << "Maintenance for this double room" << endl;
+    }
+    void visit(DeluxRoom *deluxRoom) override {
+        cout << "Maintenance for this deluxe room" << endl;
+    }
+};
+
+// Composite Visitor class that applies several visitors in one traversal
+class CompositeRoomVisitor : public RoomVisitor {
+    vector<RoomVisitor *> visitors;
+
+public:
+    CompositeRoomVisitor() {}
+    CompositeRoomVisitor(vector<RoomVisitor *> v) : visitors(move(v)) {}
+
+    /**
+     * Appends a visitor; visitors are called in the order they were added.
+     * @param visitor Pointer to any RoomVisitor, not owned
+     */
+    void add(RoomVisitor *visitor) {
+        visitors.push_back(visitor);
+    }
+
+    /**
+     * Calls the single room handler of every visitor.
+     * @param singleRoom Pointer to a SingleRoom object
+     */
+    void visit(SingleRoom *singleRoom) override {
+        for (RoomVisitor *visitor : visitors) {
+            visitor->visit(singleRoom);
+        }
+    }
+
+    /**
+     * Calls the double room handler of every visitor.
+     * @param doubleRoom Pointer to a DoubleRoom object
+     */
+    void visit(DoubleRoom *doubleRoom) override {
+        for (RoomVisitor *visitor : visitors) {
+            visitor->visit(doubleRoom);
+        }
+    }
+
+    /**
+     * Calls the deluxe room handler of every visitor.
+     * @param deluxRoom Pointer to a DeluxRoom object
+     */
+    void visit(DeluxRoom *deluxRoom) override {
+        for (RoomVisitor *visitor : visitors) {
+            visitor->visit(deluxRoom);
+        }
+    }
+};
+
+// Concrete Visitor class that totals the price of one room type, for the benchmark
+class RoomTypeTotalVisitor : public RoomVisitor {
+    int roomType; // 0 single, 1 double, 2 deluxe
+
+public:
+    long long total = 0;
+
+    RoomTypeTotalVisitor(int type) : roomType(type) {}
+
+    void visit(SingleRoom *singleRoom) override {
+        total += roomType == 0 ? singleRoom->roomPrice : 0;
+    }
+    void visit(DoubleRoom *doubleRoom) override {
+        total += roomType == 1 ? doubleRoom->roomPrice : 0;
+    }
+    void visit(DeluxRoom *deluxRoom) override {
+        total += roomType == 2 ? deluxRoom->roomPrice : 0;
+    }
+};
+
+// Size of the largest CPU cache reported by Linux, or 32 MB when it cannot be read.
+size_t lastLevelCacheBytes() {
+    size_t largest = 0;
+    for (int index = 0; index < 8; index++) {
+        ifstream file("/sys/devices/system/cpu/cpu0/cache/index" + to_string(index) + "/size");
+        size_t size;
+        string unit;
+        if (file >> size) {
+            file >> unit;
+            largest = max(largest, unit == "M" ? size << 20 : unit == "K" ? size << 10 : size);
+        }
+    }
+    return largest > 0 ? largest : 32 << 20;
+}
+
+double secondsOf(function<void()> f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Applies N visitors to `count` heap rooms with N separate passes and with one fused pass.
+void benchmark(size_t count, vector<int> visitorCounts) {
+    mt19937 rng(1);
+    vector<unique_ptr<RoomElement>> rooms;
+    rooms.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        switch (rng() % 3) {
+        case 0: rooms.emplace_back(new SingleRoom()); break;
+        case 1: rooms.emplace_back(new DoubleRoom()); break;
+        default: rooms.emplace_back(new DeluxRoom()); break;
+        }
+    }
+    size_t roomBytes = count * (sizeof(unique_ptr<RoomElement>) + 32); // Pointer plus a 32-byte heap block
+    cout << count << " rooms, about " << (roomBytes >> 20) << " MB, last-level cache "
+         << (lastLevelCacheBytes() >> 20) << " MB" << endl;
+    cout << fixed << setprecision(2);
+
+    for (int n : visitorCounts) {
+        vector<RoomTypeTotalVisitor> separate, fused;
+        for (int v = 0; v < n; v++) {
+            separate.emplace_back(v % 3);
+            fused.emplace_back(v % 3);
+        }
+        double separateSeconds = secondsOf([&]() {
+            for (RoomTypeTotalVisitor &visitor : separate) {
+                for (auto &room : rooms) {
+                    room->accept(&visitor);
+                }
+            }
+        });
+        CompositeRoomVisitor composite;
+        for (RoomTypeTotalVisitor &visitor : fused) {
+            composite.add(&visitor);
+        }
+        double fusedSeconds = secondsOf([&]() {
+            for (auto &room : rooms) {
+                room->accept(&composite);
+            }
+        });
+        bool same = true;
+        for (int v = 0; v < n; v++) {
+            same = same && separate[v].total == fused[v].total;
+        }
+        cout << setw(2) << n << " visitors: separate passes " << setw(6) << separateSeconds << " s, fused "
+             << setw(6) << fusedSeconds << " s, speedup " << setw(5) << separateSeconds / fusedSeconds
+             << "x, totals " << (same ? "match" : "DIFFER") << endl;
+    }
+}
+
+int main() {
+    // Create instances of different room types
+    SingleRoom *singleRoom = new SingleRoom();
+    DoubleRoom *doubleRoom = new DoubleRoom();
+    DeluxRoom *deluxRoom = new DeluxRoom();
+
+    // Create instances of different visitors (Room Pricing and Room Maintenance)
+    RoomVisitor *roomPricingVisitor = new RoomPricingVisitor();
+    RoomVisitor *roomMaintainenceVisitor = new RoomMaintainenceVisitor();
+
+    // One traversal runs both visitors on each room
+    CompositeRoomVisitor pricingAndMaintenance({roomPricingVisitor, roomMaintainenceVisitor});
+    singleRoom->accept(&pricingAndMaintenance);
+    doubleRoom->accept(&pricingAndMaintenance);
+    deluxRoom->accept(&pricingAndMaintenance);
+
+    cout << "-----------------" << endl;
+
+    benchmark(16000000, {1, 2, 4, 8});
+
+    delete singleRoom;
+    delete doubleRoom;
+    delete deluxRoom;
+    delete roomPricingVisitor;
+    delete roomMaintainenceVisitor;
+
+    return 0;
+}
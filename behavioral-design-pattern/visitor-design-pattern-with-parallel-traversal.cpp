@@ -0,0 +1,457 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Visitor Design Pattern with Parallel Traversal:
+// The classic visitors walk the rooms one call at a time on one thread. This variant adds a
+// ParallelVisitDriver that splits a room collection across a WorkStealingPool. A visitor that
+// should run in parallel implements MergeableRoomVisitor: the driver forks one copy of the visitor
+// per worker, so each worker updates only its own state, and merges the copies back into the
+// original visitor when the traversal ends. RoomPricingVisitor keeps running totals and
+// RoomMaintainenceVisitor keeps maintenance counts, so both merge; user visitors opt in the same
+// way.
+
+class SingleRoom; // Forward declaration
+class DoubleRoom; // Forward declaration
+class DeluxRoom;  // Forward declaration
+
+// Abstract Visitor class defining the visit methods for different room types
+class RoomVisitor {
+public:
+    virtual void visit(SingleRoom *singleRoom) = 0; // Visit single room
+    virtual void visit(DoubleRoom *doubleRoom) = 0; // Visit double room
+    virtual void visit(DeluxRoom *deluxRoom) = 0;   // Visit deluxe room
+    virtual ~RoomVisitor() = default;
+};
+
+// Abstract Element class with the accept method
+class RoomElement {
+public:
+    virtual void accept(RoomVisitor *visitor) = 0; // Accept visitor
+    virtual ~RoomElement() = default;
+};
+
+// Concrete Element class for a single room
+class SingleRoom : public RoomElement {
+public:
+    int roomPrice = 1000; // Price of a single room
+    void accept(RoomVisitor *visitor) override {
+        visitor->visit(this); // Accept a visitor and call its visit method
+    }
+};
+
+// Concrete Element class for a double room
+class DoubleRoom : public RoomElement {
+public:
+    int roomPrice = 2000; // Price of a double room
+    void accept(RoomVisitor *visitor) override {
+        visitor->visit(this); // Accept a visitor and call its visit method
+    }
+};
+
+// Concrete Element class for a deluxe room
+class DeluxRoom : public RoomElement {
+public:
+    int roomPrice = 3000; // Price of a deluxe room
+    void accept(RoomVisitor *visitor) override {
+        visitor->visit(this); // Accept a visitor and call its visit method
+    }
+};
+
+// Abstract Visitor class for visitors that can run in parallel. Aligned to a cache line so the
+// forked copies of different workers never share one.
+class alignas(64) MergeableRoomVisitor : public RoomVisitor {
+public:
+    /**
+     * Creates a visitor of the same type with empty state, for one worker. The caller owns it.
+     */
+    virtual MergeableRoomVisitor *fork() = 0;
+
+    /**
+     * Adds the state of a visitor returned by fork() to this visitor.
+     * @param other Pointer to a forked visitor of the same type
+     */
+    virtual void merge(MergeableRoomVisitor *other) = 0;
+};
+
+// Concrete Visitor class for calculating the pricing of rooms
+// Keeps running totals instead of printing every room, so copies on different threads can be
+// merged.
+class RoomPricingVisitor : public MergeableRoomVisitor {
+public:
+    long long roomsPriced = 0;
+    long long totalPrice = 0;
+
+    /**
+     * Adds the price of a single room to the running total.
+     * @param singleRoom Pointer to a SingleRoom object
+     */
+    void visit(SingleRoom *singleRoom) override {
+        roomsPriced++;
+        totalPrice += singleRoom->roomPrice;
+    }
+
+    /**
+     * Adds the price of a double room to the running total.
+     * @param doubleRoom Pointer to a DoubleRoom object
+     */
+    void visit(DoubleRoom *doubleRoom) override {
+        roomsPriced++;
+        totalPrice += doubleRoom->roomPrice;
+    }
+
+    /**
+     * Adds the price of a deluxe room to the running total.
+     * @param deluxRoom Pointer to a DeluxRoom object
+     */
+    void visit(DeluxRoom *deluxRoom) override {
+        roomsPriced++;
+        totalPrice += deluxRoom->roomPrice;
+    }
+
+    MergeableRoomVisitor *fork() override {
+        return new RoomPricingVisitor();
+    }
+
+    void merge(MergeableRoomVisitor *other) override {
+        RoomPricingVisitor *pricing = static_cast<RoomPricingVisitor *>(other);
+        roomsPriced += pricing->roomsPriced;
+        totalPrice += pricing->totalPrice;
+    }
+
+    void printReport() {
+        cout << "Price for " << roomsPriced << " rooms is " << totalPrice << endl;
+    }
+};
+
+// Concrete Visitor class for performing maintenance on rooms
+// Counts the rooms scheduled for maintenance by type.
+class RoomMaintainenceVisitor : public MergeableRoomVisitor {
+public:
+    long long singleRooms = 0;
+    long long doubleRooms = 0;
+    long long deluxRooms = 0;
+
+    void visit(SingleRoom *singleRoom) override {
+        singleRooms++;
+    }
+    void visit(DoubleRoom *doubleRoom) override {
+        doubleRooms++;
+    }
+    void visit(DeluxRoom *deluxRoom) override {
+        deluxRooms++;
+    }
+
+    MergeableRoomVisitor *fork() override {
+        return new RoomMaintainenceVisitor();
+    }
+
+    void merge(MergeableRoomVisitor *other) override {
+        RoomMaintainenceVisitor *maintenance = static_cast<RoomMaintainenceVisitor *>(other);
+        singleRooms += maintenance->singleRooms;
+        doubleRooms += maintenance->doubleRooms;
+        deluxRooms += maintenance->deluxRooms;
+    }
+
+    void printReport() {
+        cout << "Maintenance for " << singleRooms << " single rooms, " << doubleRooms << " double rooms and "
+             << deluxRooms << " deluxe rooms" << endl;
+    }
+};
+
+// A user visitor that opts in to parallel traversal: the price range of the deluxe rooms
+class DeluxPriceRangeVisitor : public MergeableRoomVisitor {
+public:
+    int lowest = INT_MAX;
+    int highest = INT_MIN;
+
+    void visit(SingleRoom *singleRoom) override {}
+    void visit(DoubleRoom *doubleRoom) override {}
+    void visit(DeluxRoom *deluxRoom) override {
+        lowest = min(lowest, deluxRoom->roomPrice);
+        highest = max(highest, deluxRoom->roomPrice);
+    }
+
+    MergeableRoomVisitor *fork() override {
+        return new DeluxPriceRangeVisitor();
+    }
+
+    void merge(MergeableRoomVisitor *other) override {
+        DeluxPriceRangeVisitor *range = static_cast<DeluxPriceRangeVisitor *>(other);
+        lowest = min(lowest, range->lowest);
+        highest = max(highest, range->highest);
+    }
+};
+
+// WorkStealingPool class
+// A fixed set of workers, the calling thread being worker 0. parallelFor() puts the whole index
+// range on worker 0's deque. A worker takes ranges from the back of its own deque and, when that is
+// empty, steals from the front of another worker's deque. Before running a range it splits off the
+// upper half onto its own deque until the range is no larger than the grain, so big ranges stay
+// available to thieves and the load balances itself.
+class WorkStealingPool {
+    struct Range {
+        size_t begin;
+        size_t end;
+    };
+
+    struct WorkerQueue {
+        mutex lock;
+        deque<Range> ranges;
+    };
+
+    int workerCount;
+    vector<unique_ptr<WorkerQueue>> queues;
+    vector<thread> threads;
+
+    // The current job, published to the workers under jobLock
+    mutex jobLock;
+    condition_variable jobStarted;
+    condition_variable jobFinished;
+    long long jobNumber = 0;
+    int busyWorkers = 0;
+    bool stopping = false;
+    function<void(int, size_t, size_t)> body;
+    size_t grain = 1;
+    atomic<size_t> remaining{0};
+    atomic<long long> steals{0};
+
+    bool takeOwn(int worker, Range &range) {
+        WorkerQueue &queue = *queues[worker];
+        lock_guard<mutex> guard(queue.lock);
+        if (queue.ranges.empty()) {
+            return false;
+        }
+        range = queue.ranges.back();
+        queue.ranges.pop_back();
+        return true;
+    }
+
+    bool steal(int worker, Range &range, mt19937 &rng) {
+        int start = rng() % workerCount;
+        for (int k = 0; k < workerCount; k++) {
+            int victim = (start + k) % workerCount;
+            if (victim == worker) {
+                continue;
+            }
+            WorkerQueue &queue = *queues[victim];
+            lock_guard<mutex> guard(queue.lock);
+            if (!queue.ranges.empty()) {
+                range = queue.ranges.front();
+                queue.ranges.pop_front();
+                steals++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void work(int worker) {
+        mt19937 rng(worker + 1);
+        while (remaining.load() > 0) {
+            Range range;
+            if (!takeOwn(worker, range) && !steal(worker, range, rng)) {
+                this_thread::yield();
+                continue;
+            }
+            while (range.end - range.begin > grain) {
+                size_t middle = range.begin + (range.end - range.begin) / 2;
+                {
+                    lock_guard<mutex> guard(queues[worker]->lock);
+                    queues[worker]->ranges.push_back({middle, range.end});
+                }
+                range.end = middle;
+            }
+            body(worker, range.begin, range.end);
+            remaining -= range.end - range.begin;
+        }
+    }
+
+    void workerLoop(int worker) {
+        long long seen = 0;
+        while (true) {
+            {
+                unique_lock<mutex> guard(jobLock);
+                jobStarted.wait(guard, [&]() { return stopping || jobNumber != seen; });
+                if (stopping) {
+                    return;
+                }
+                seen = jobNumber;
+            }
+            work(worker);
+            lock_guard<mutex> guard(jobLock);
+            if (--busyWorkers == 0) {
+                jobFinished.notify_all();
+            }
+        }
+    }
+
+public:
+    WorkStealingPool(int workers) : workerCount(max(workers, 1)) {
+        for (int w = 0; w < workerCount; w++) {
+            queues.emplace_back(new WorkerQueue());
+        }
+        for (int w = 1; w < workerCount; w++) {
+            threads.emplace_back(&WorkStealingPool::workerLoop, this, w);
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            lock_guard<mutex> guard(jobLock);
+            stopping = true;
+        }
+        jobStarted.notify_all();
+        for (thread &t : threads) {
+            t.join();
+        }
+    }
+
+    int size() {
+        return workerCount;
+    }
+
+    long long stealCount() {
+        return steals.load();
+    }
+
+    /**
+     * Runs f(worker, begin, end) over disjoint ranges covering [0, count) and returns when all of
+     * them are done. The worker index is below size() and no two ranges run on one worker at once.
+     * @param count Number of indices
+     * @param grainSize Largest range handed to f
+     * @param f Function to run on each range
+     */
+    void parallelFor(size_t count, size_t grainSize, function<void(int, size_t, size_t)> f) {
+        if (count == 0) {
+            return;
+        }
+        {
+            lock_guard<mutex> guard(jobLock);
+            body = move(f);
+            grain = max<size_t>(grainSize, 1);
+            remaining = count;
+            {
+                lock_guard<mutex> queueGuard(queues[0]->lock);
+                queues[0]->ranges.push_back({0, count});
+            }
+            jobNumber++;
+            busyWorkers = workerCount - 1;
+        }
+        jobStarted.notify_all();
+        work(0);
+        unique_lock<mutex> guard(jobLock);
+        jobFinished.wait(guard, [&]() { return busyWorkers == 0; });
+    }
+};
+
+// ParallelVisitDriver class
+// Applies a MergeableRoomVisitor to a room collection on a WorkStealingPool, with one forked
+// visitor per worker.
+class ParallelVisitDriver {
+    WorkStealingPool *pool;
+    size_t grain;
+
+public:
+    ParallelVisitDriver(WorkStealingPool *p, size_t grainSize = 16384) : pool(p), grain(grainSize) {}
+
+    /**
+     * Visits every room in parallel and merges the workers' results into the visitor.
+     * @param rooms Rooms to visit
+     * @param visitor Pointer to a MergeableRoomVisitor receiving the merged result
+     */
+    void visitAll(vector<RoomElement *> &rooms, MergeableRoomVisitor *visitor) {
+        vector<unique_ptr<MergeableRoomVisitor>> local;
+        for (int w = 0; w < pool->size(); w++) {
+            local.emplace_back(visitor->fork());
+        }
+        pool->parallelFor(rooms.size(), grain, [&](int worker, size_t begin, size_t end) {
+            MergeableRoomVisitor *own = local[worker].get();
+            for (size_t i = begin; i < end; i++) {
+                rooms[i]->accept(own);
+            }
+        });
+        for (auto &forked : local) {
+            visitor->merge(forked.get());
+        }
+    }
+};
+
+// Prices `count` rooms of random types with 1, 2, 4, ... up to `maxThreads` workers.
+void benchmark(size_t count, int passes, int maxThreads) {
+    mt19937 rng(1);
+    vector<unique_ptr<RoomElement>> owned;
+    vector<RoomElement *> rooms;
+    owned.reserve(count);
+    rooms.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        switch (rng() % 3) {
+        case 0: owned.emplace_back(new SingleRoom()); break;
+        case 1: owned.emplace_back(new DoubleRoom()); break;
+        default: owned.emplace_back(new DeluxRoom()); break;
+        }
+        rooms.push_back(owned.back().get());
+    }
+
+    RoomPricingVisitor serial;
+    for (RoomElement *room : rooms) {
+        room->accept(&serial);
+    }
+
+    cout << count << " rooms, " << thread::hardware_concurrency() << " hardware threads" << endl;
+    cout << fixed << setprecision(2);
+    double baseRate = 0;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        WorkStealingPool pool(threads);
+        ParallelVisitDriver driver(&pool);
+        bool same = true;
+        auto start = chrono::steady_clock::now();
+        for (int p = 0; p < passes; p++) {
+            RoomPricingVisitor pricing;
+            driver.visitAll(rooms, &pricing);
+            same = same && pricing.totalPrice == serial.totalPrice && pricing.roomsPriced == serial.roomsPriced;
+        }
+        double rate = (double)count * passes / chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        if (threads == 1) {
+            baseRate = rate;
+        }
+        cout << setw(3) << threads << " threads: " << setw(8) << rate / 1e6 << " M rooms/s, speedup "
+             << setw(5) << rate / baseRate << "x, " << pool.stealCount() << " steals, totals "
+             << (same ? "match" : "DIFFER") << endl;
+    }
+}
+
+int main() {
+    // Creating different types of rooms
+    vector<unique_ptr<RoomElement>> hotel;
+    for (int i = 0; i < 10; i++) {
+        hotel.emplace_back(new SingleRoom());
+        hotel.emplace_back(new DoubleRoom());
+        hotel.emplace_back(new DeluxRoom());
+    }
+    vector<RoomElement *> rooms;
+    for (auto &room : hotel) {
+        rooms.push_back(room.get());
+    }
+
+    WorkStealingPool pool(4);
+    ParallelVisitDriver driver(&pool, 4);
+
+    // Built-in visitors, each worker with its own copy
+    RoomPricingVisitor roomPricingVisitor;
+    RoomMaintainenceVisitor roomMaintainenceVisitor;
+    driver.visitAll(rooms, &roomPricingVisitor);
+    driver.visitAll(rooms, &roomMaintainenceVisitor);
+    roomPricingVisitor.printReport();
+    roomMaintainenceVisitor.printReport();
+    cout << "-----------------" << endl;
+
+    // A user visitor that opted in to merging
+    DeluxPriceRangeVisitor range;
+    driver.visitAll(rooms, &range);
+    cout << "Deluxe rooms cost between " << range.lowest << " and " << range.highest << endl;
+    cout << "-----------------" << endl;
+
+    benchmark(8000000, 3, 64);
+
+    return 0;
+}
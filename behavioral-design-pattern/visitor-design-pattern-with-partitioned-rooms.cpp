@@ -0,0 +1,418 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Visitor Design Pattern with Partitioned Rooms:
+// The classic RoomPricingVisitor looks at one room per call, which is fine for printing a price
+// but not for aggregate pricing over a very large inventory. This variant adds a
+// PartitionedRoomStore that keeps the roomPrice of each room type in its own dense array, and a
+// batch form of the visitor, RoomBatchVisitor, that receives a whole partition per call. The
+// BatchPricingVisitor reduces each partition to a total, a min/max and a price histogram with SIMD
+// lanes, and gives the same PriceStats as the per-room RoomStatsVisitor.
+
+class SingleRoom; // Forward declaration
+class DoubleRoom; // Forward declaration
+class DeluxRoom;  // Forward declaration
+
+// Abstract Visitor class defining the visit methods for different room types
+class RoomVisitor {
+public:
+    virtual void visit(SingleRoom *singleRoom) = 0; // Visit single room
+    virtual void visit(DoubleRoom *doubleRoom) = 0; // Visit double room
+    virtual void visit(DeluxRoom *deluxRoom) = 0;   // Visit deluxe room
+    virtual ~RoomVisitor() = default;
+};
+
+// Abstract Element class with the accept method
+class RoomElement {
+public:
+    virtual void accept(RoomVisitor *visitor) = 0; // Accept visitor
+    virtual ~RoomElement() = default;
+};
+
+// Concrete Element class for a single room
+class SingleRoom : public RoomElement {
+public:
+    int roomPrice = 1000; // Price of a single room
+    void accept(RoomVisitor *visitor) override {
+        visitor->visit(this); // Accept a visitor and call its visit method
+    }
+};
+
+// Concrete Element class for a double room
+class DoubleRoom : public RoomElement {
+public:
+    int roomPrice = 2000; // Price of a double room
+    void accept(RoomVisitor *visitor) override {
+        visitor->visit(this); // Accept a visitor and call its visit method
+    }
+};
+
+// Concrete Element class for a deluxe room
+class DeluxRoom : public RoomElement {
+public:
+    int roomPrice = 3000; // Price of a deluxe room
+    void accept(RoomVisitor *visitor) override {
+        visitor->visit(this); // Accept a visitor and call its visit method
+    }
+};
+
+// Concrete Visitor class for calculating the pricing of rooms
+class RoomPricingVisitor : public RoomVisitor {
+public:
+    /**
+     * Prints the price of a single room to the console.
+     * @param singleRoom Pointer to a SingleRoom object
+     */
+    void visit(SingleRoom *singleRoom) override {
+        cout << "Price for this single room is " << singleRoom->roomPrice << endl;
+    }
+
+    /**
+     * Prints the price of a double room to the console.
+     * @param doubleRoom Pointer to a DoubleRoom object
+     */
+    void visit(DoubleRoom *doubleRoom) override {
+        cout << "Price for this double room is " << doubleRoom->roomPrice << endl;
+    }
+
+    /**
+     * Prints the price of a deluxe room to the console.
+     * @param deluxRoom Pointer to a DeluxRoom object
+     */
+    void visit(DeluxRoom *deluxRoom) override {
+        cout << "Price for this deluxe room is " << deluxRoom->roomPrice << endl;
+    }
+};
+
+// Aggregate pricing of a set of rooms: count, total, min/max and a histogram of prices in buckets
+// of BUCKET_WIDTH. Prices from (BUCKETS - 1) * BUCKET_WIDTH upwards share the last bucket, and
+// negative prices the first.
+struct PriceStats {
+    static const int BUCKET_WIDTH = 500;
+    static const int BUCKETS = 16;
+
+    long long count = 0;
+    long long total = 0;
+    int minPrice = INT_MAX;
+    int maxPrice = INT_MIN;
+    long long histogram[BUCKETS] = {};
+
+    static int bucketOf(int price) {
+        return min((unsigned)max(price, 0) / BUCKET_WIDTH, (unsigned)BUCKETS - 1);
+    }
+
+    void add(int price) {
+        count++;
+        total += price;
+        minPrice = min(minPrice, price);
+        maxPrice = max(maxPrice, price);
+        histogram[bucketOf(price)]++;
+    }
+
+    void merge(const PriceStats &other) {
+        count += other.count;
+        total += other.total;
+        minPrice = min(minPrice, other.minPrice);
+        maxPrice = max(maxPrice, other.maxPrice);
+        for (int b = 0; b < BUCKETS; b++) {
+            histogram[b] += other.histogram[b];
+        }
+    }
+
+    bool operator==(const PriceStats &other) const {
+        return count == other.count && total == other.total && minPrice == other.minPrice &&
+               maxPrice == other.maxPrice && equal(histogram, histogram + BUCKETS, other.histogram);
+    }
+
+    void print(const string &label) const {
+        cout << label << ": " << count << " rooms, total " << total;
+        if (count > 0) {
+            cout << ", min " << minPrice << ", max " << maxPrice << ", mean " << (double)total / count;
+        }
+        cout << endl;
+    }
+};
+
+enum RoomType { SINGLE_ROOM, DOUBLE_ROOM, DELUX_ROOM, ROOM_TYPES };
+
+// Concrete Visitor class that aggregates prices one room at a time, per room type
+class RoomStatsVisitor : public RoomVisitor {
+public:
+    PriceStats stats[ROOM_TYPES];
+
+    void visit(SingleRoom *singleRoom) override {
+        stats[SINGLE_ROOM].add(singleRoom->roomPrice);
+    }
+    void visit(DoubleRoom *doubleRoom) override {
+        stats[DOUBLE_ROOM].add(doubleRoom->roomPrice);
+    }
+    void visit(DeluxRoom *deluxRoom) override {
+        stats[DELUX_ROOM].add(deluxRoom->roomPrice);
+    }
+};
+
+// Abstract batch Visitor class: each method receives every room of one type at once, as a dense
+// array of prices.
+class RoomBatchVisitor {
+public:
+    virtual void visitSingleRooms(const int *roomPrices, size_t count) = 0;
+    virtual void visitDoubleRooms(const int *roomPrices, size_t count) = 0;
+    virtual void visitDeluxRooms(const int *roomPrices, size_t count) = 0;
+    virtual ~RoomBatchVisitor() = default;
+};
+
+// Four int lanes and four long long lanes, as GCC vector types. The compiler maps them onto the
+// target's SIMD registers (SSE2 on baseline x86-64, NEON on ARM) without intrinsics.
+typedef int32_t IntLanes __attribute__((vector_size(16)));
+typedef int64_t WideLanes __attribute__((vector_size(32)));
+
+/**
+ * Reduces a dense array of prices to PriceStats. Sum, min and max run on IntLanes, eight prices
+ * per iteration in two independent accumulators. The histogram is a scatter, which has no SIMD form
+ * on these targets, so it is counted in scalar code into one sub-histogram per lane: consecutive
+ * increments of the same bucket then do not wait on each other.
+ * @param prices Pointer to the first price
+ * @param count Number of prices
+ */
+PriceStats reducePrices(const int *prices, size_t count) {
+    PriceStats stats;
+    stats.count = count;
+    WideLanes sum0 = {}, sum1 = {};
+    IntLanes low0 = {INT_MAX, INT_MAX, INT_MAX, INT_MAX}, low1 = low0;
+    IntLanes high0 = {INT_MIN, INT_MIN, INT_MIN, INT_MIN}, high1 = high0;
+    long long laneHistogram[8][PriceStats::BUCKETS] = {};
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        IntLanes a, b;
+        memcpy(&a, prices + i, sizeof(a));
+        memcpy(&b, prices + i + 4, sizeof(b));
+        sum0 += __builtin_convertvector(a, WideLanes);
+        sum1 += __builtin_convertvector(b, WideLanes);
+        low0 = a < low0 ? a : low0;
+        low1 = b < low1 ? b : low1;
+        high0 = a > high0 ? a : high0;
+        high1 = b > high1 ? b : high1;
+        for (int lane = 0; lane < 8; lane++) {
+            laneHistogram[lane][PriceStats::bucketOf(prices[i + lane])]++;
+        }
+    }
+
+    sum0 += sum1;
+    low0 = low1 < low0 ? low1 : low0;
+    high0 = high1 > high0 ? high1 : high0;
+    for (int lane = 0; lane < 4; lane++) {
+        stats.total += sum0[lane];
+        stats.minPrice = min(stats.minPrice, (int)low0[lane]);
+        stats.maxPrice = max(stats.maxPrice, (int)high0[lane]);
+    }
+    for (int lane = 0; lane < 8; lane++) {
+        for (int b = 0; b < PriceStats::BUCKETS; b++) {
+            stats.histogram[b] += laneHistogram[lane][b];
+        }
+    }
+    for (; i < count; i++) { // Tail of fewer than eight prices
+        stats.total += prices[i];
+        stats.minPrice = min(stats.minPrice, prices[i]);
+        stats.maxPrice = max(stats.maxPrice, prices[i]);
+        stats.histogram[PriceStats::bucketOf(prices[i])]++;
+    }
+    return stats;
+}
+
+// Concrete batch Visitor class that aggregates prices one partition at a time, per room type
+class BatchPricingVisitor : public RoomBatchVisitor {
+public:
+    PriceStats stats[ROOM_TYPES];
+
+    void visitSingleRooms(const int *roomPrices, size_t count) override {
+        stats[SINGLE_ROOM].merge(reducePrices(roomPrices, count));
+    }
+    void visitDoubleRooms(const int *roomPrices, size_t count) override {
+        stats[DOUBLE_ROOM].merge(reducePrices(roomPrices, count));
+    }
+    void visitDeluxRooms(const int *roomPrices, size_t count) override {
+        stats[DELUX_ROOM].merge(reducePrices(roomPrices, count));
+    }
+};
+
+// PartitionedRoomStore class
+// Keeps only the roomPrice of each room, in one dense array per room type. A batch visitor gets
+// one call per type; a classic RoomVisitor still works and is handed a temporary room per price.
+class PartitionedRoomStore {
+    vector<int> prices[ROOM_TYPES];
+
+public:
+    void add(const SingleRoom &room) {
+        prices[SINGLE_ROOM].push_back(room.roomPrice);
+    }
+    void add(const DoubleRoom &room) {
+        prices[DOUBLE_ROOM].push_back(room.roomPrice);
+    }
+    void add(const DeluxRoom &room) {
+        prices[DELUX_ROOM].push_back(room.roomPrice);
+    }
+
+    void reserve(RoomType type, size_t count) {
+        prices[type].reserve(count);
+    }
+
+    size_t size() {
+        return prices[SINGLE_ROOM].size() + prices[DOUBLE_ROOM].size() + prices[DELUX_ROOM].size();
+    }
+
+    /**
+     * Hands every partition to a batch visitor, one call per room type.
+     * @param visitor Pointer to a RoomBatchVisitor
+     */
+    void accept(RoomBatchVisitor *visitor) {
+        visitor->visitSingleRooms(prices[SINGLE_ROOM].data(), prices[SINGLE_ROOM].size());
+        visitor->visitDoubleRooms(prices[DOUBLE_ROOM].data(), prices[DOUBLE_ROOM].size());
+        visitor->visitDeluxRooms(prices[DELUX_ROOM].data(), prices[DELUX_ROOM].size());
+    }
+
+    /**
+     * Visits every room one at a time with a classic visitor.
+     * @param visitor Pointer to a RoomVisitor
+     */
+    void accept(RoomVisitor *visitor) {
+        SingleRoom singleRoom;
+        for (int price : prices[SINGLE_ROOM]) {
+            singleRoom.roomPrice = price;
+            visitor->visit(&singleRoom);
+        }
+        DoubleRoom doubleRoom;
+        for (int price : prices[DOUBLE_ROOM]) {
+            doubleRoom.roomPrice = price;
+            visitor->visit(&doubleRoom);
+        }
+        DeluxRoom deluxRoom;
+        for (int price : prices[DELUX_ROOM]) {
+            deluxRoom.roomPrice = price;
+            visitor->visit(&deluxRoom);
+        }
+    }
+};
+
+template <typename F>
+double roomsPerSecond(size_t rooms, F f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    return rooms / chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+bool sameStats(const PriceStats *a, const PriceStats *b) {
+    return equal(a, a + ROOM_TYPES, b);
+}
+
+// Fills a store with `count` rooms of random types and prices and aggregates them per room and in
+// batches. The classic heap rooms, at about 40 bytes per room, are only built for the first
+// `heapCount` rooms so the benchmark fits in memory.
+void benchmark(size_t count, size_t heapCount) {
+    mt19937 rng(1);
+    PartitionedRoomStore store;
+    PartitionedRoomStore heapPrefix;
+    vector<unique_ptr<RoomElement>> heapRooms;
+    for (int t = 0; t < ROOM_TYPES; t++) {
+        store.reserve((RoomType)t, count / 3 + count / 100 + 8);
+        heapPrefix.reserve((RoomType)t, heapCount / 3 + heapCount / 100 + 8);
+    }
+    heapRooms.reserve(heapCount);
+    for (size_t i = 0; i < count; i++) {
+        uint32_t r = rng();
+        switch (r % 3) {
+        case 0: {
+            SingleRoom room;
+            room.roomPrice = 800 + (r >> 8) % 401;
+            store.add(room);
+            if (i < heapCount) {
+                heapPrefix.add(room);
+                heapRooms.emplace_back(new SingleRoom(room));
+            }
+            break;
+        }
+        case 1: {
+            DoubleRoom room;
+            room.roomPrice = 1600 + (r >> 8) % 801;
+            store.add(room);
+            if (i < heapCount) {
+                heapPrefix.add(room);
+                heapRooms.emplace_back(new DoubleRoom(room));
+            }
+            break;
+        }
+        default: {
+            DeluxRoom room;
+            room.roomPrice = 2500 + (r >> 8) % 5001;
+            store.add(room);
+            if (i < heapCount) {
+                heapPrefix.add(room);
+                heapRooms.emplace_back(new DeluxRoom(room));
+            }
+            break;
+        }
+        }
+    }
+
+    cout << fixed << setprecision(1);
+
+    // Classic heap rooms against batches over the same rooms
+    RoomStatsVisitor heapVisitor;
+    double heapRate = roomsPerSecond(heapCount, [&]() {
+        for (auto &room : heapRooms) {
+            room->accept(&heapVisitor);
+        }
+    });
+    BatchPricingVisitor prefixBatch;
+    heapPrefix.accept(&prefixBatch);
+    heapRooms.clear();
+    heapRooms.shrink_to_fit();
+
+    // Per-room and batch visitors over the whole store
+    RoomStatsVisitor perRoom;
+    double perRoomRate = roomsPerSecond(count, [&]() { store.accept(&perRoom); });
+    BatchPricingVisitor batch;
+    double batchRate = roomsPerSecond(count, [&]() { store.accept(&batch); });
+
+    bool same = sameStats(heapVisitor.stats, prefixBatch.stats) && sameStats(perRoom.stats, batch.stats);
+    cout << count << " rooms, per-room and batch results match: " << (same ? "yes" : "NO") << endl;
+    PriceStats all;
+    for (int t = 0; t < ROOM_TYPES; t++) {
+        all.merge(batch.stats[t]);
+    }
+    all.print("all rooms");
+    cout << "heap rooms, RoomStatsVisitor       " << setw(8) << heapRate / 1e6 << " M rooms/s (first "
+         << heapCount << " rooms)" << endl;
+    cout << "partitioned, RoomStatsVisitor      " << setw(8) << perRoomRate / 1e6 << " M rooms/s" << endl;
+    cout << "partitioned, BatchPricingVisitor   " << setw(8) << batchRate / 1e6 << " M rooms/s" << endl;
+}
+
+int main() {
+    // A small hotel stored by room type
+    PartitionedRoomStore hotel;
+    SingleRoom cheapSingle;
+    cheapSingle.roomPrice = 900;
+    hotel.add(SingleRoom());
+    hotel.add(cheapSingle);
+    hotel.add(DoubleRoom());
+    hotel.add(DeluxRoom());
+
+    // The classic visitor still works one room at a time
+    RoomVisitor *roomPricingVisitor = new RoomPricingVisitor();
+    hotel.accept(roomPricingVisitor);
+    cout << "-----------------" << endl;
+
+    // The batch visitor aggregates each room type in one call
+    BatchPricingVisitor pricing;
+    hotel.accept(&pricing);
+    pricing.stats[SINGLE_ROOM].print("single rooms");
+    pricing.stats[DOUBLE_ROOM].print("double rooms");
+    pricing.stats[DELUX_ROOM].print("deluxe rooms");
+    cout << "-----------------" << endl;
+
+    benchmark(100000000, 10000000);
+
+    delete roomPricingVisitor;
+
+    return 0;
+}
@@ -0,0 +1,275 @@
+#include <bits/stdc++.h>
+using namespace std;
+
+// Visitor Design Pattern with Variant Rooms:
+// In the classic version every room is a separate heap object and every visit costs two virtual
+// calls, accept() and then visit(). This variant adds a RoomCollection that stores the rooms by
+// value as a std::variant in one contiguous vector. A visitor is then any callable with an
+// overload per room type, applied through std::visit, which the compiler lowers to a switch on
+// the variant index: the type is dispatched once and the handler can be inlined. Existing
+// RoomVisitor implementations still work on the collection through the RoomVisitorAdapter.
+
+class SingleRoom; // Forward declaration
+class DoubleRoom; // Forward declaration
+class DeluxRoom;  // Forward declaration
+
+// Abstract Visitor class defining the visit methods for different room types
+class RoomVisitor {
+public:
+    virtual void visit(SingleRoom *singleRoom) = 0; // Visit single room
+    virtual void visit(DoubleRoom *doubleRoom) = 0; // Visit double room
+    virtual void visit(DeluxRoom *deluxRoom) = 0;   // Visit deluxe room
+    virtual ~RoomVisitor() = default;
+};
+
+// Abstract Element class with the accept method
+class RoomElement {
+public:
+    virtual void accept(RoomVisitor *visitor) = 0; // Accept visitor
+    virtual ~RoomElement() = default;
+};
+
+// Concrete Element class for a single room
+class SingleRoom : public RoomElement {
+public:
+    int roomPrice = 1000; // Price of a single room
+    void accept(RoomVisitor *visitor) override {
+        visitor->visit(this); // Accept a visitor and call its visit method
+    }
+};
+
+// Concrete Element class for a double room
+class DoubleRoom : public RoomElement {
+public:
+    int roomPrice = 2000; // Price of a double room
+    void accept(RoomVisitor *visitor) override {
+        visitor->visit(this); // Accept a visitor and call its visit method
+    }
+};
+
+// Concrete Element class for a deluxe room
+class DeluxRoom : public RoomElement {
+public:
+    int roomPrice = 3000; // Price of a deluxe room
+    void accept(RoomVisitor *visitor) override {
+        visitor->visit(this); // Accept a visitor and call its visit method
+    }
+};
+
+// Concrete Visitor class for calculating the pricing of rooms
+class RoomPricingVisitor : public RoomVisitor {
+public:
+    /**
+     * Prints the price of a single room to the console.
+     * @param singleRoom Pointer to a SingleRoom object
+     */
+    void visit(SingleRoom *singleRoom) override {
+        cout << "Price for this single room is " << singleRoom->roomPrice << endl;
+    }
+
+    /**
+     * Prints the price of a double room to the console.
+     * @param doubleRoom Pointer to a DoubleRoom object
+     */
+    void visit(DoubleRoom *doubleRoom) override {
+        cout << "Price for this double room is " << doubleRoom->roomPrice << endl;
+    }
+
+    /**
+     * Prints the price of a deluxe room to the console.
+     * @param deluxRoom Pointer to a DeluxRoom object
+     */
+    void visit(DeluxRoom *deluxRoom) override {
+        cout << "Price for this deluxe room is " << deluxRoom->roomPrice << endl;
+    }
+};
+
+// Concrete Visitor class for performing maintenance on rooms
+class RoomMaintainenceVisitor : public RoomVisitor {
+public:
+    void visit(SingleRoom *singleRoom) override {
+        cout << "Maintenance for this single room" << endl;
+    }
+    void visit(DoubleRoom *doubleRoom) override {
+        cout << "Maintenance for this double room" << endl;
+    }
+    void visit(DeluxRoom *deluxRoom) override {
+        cout << "Maintenance for this deluxe room" << endl;
+    }
+};
+
+// Concrete Visitor class that totals room prices, for the double-dispatch benchmark
+class RoomTotalVisitor : public RoomVisitor {
+public:
+    long long total = 0;
+
+    void visit(SingleRoom *singleRoom) override {
+        total += singleRoom->roomPrice;
+    }
+    void visit(DoubleRoom *doubleRoom) override {
+        total += doubleRoom->roomPrice;
+    }
+    void visit(DeluxRoom *deluxRoom) override {
+        total += deluxRoom->roomPrice;
+    }
+};
+
+// A room stored by value.
+typedef variant<SingleRoom, DoubleRoom, DeluxRoom> Room;
+
+// Static visitor that totals room prices: one overload per room type, no virtual call.
+struct PriceTotal {
+    long long total = 0;
+
+    void operator()(SingleRoom &room) {
+        total += room.roomPrice;
+    }
+    void operator()(DoubleRoom &room) {
+        total += room.roomPrice;
+    }
+    void operator()(DeluxRoom &room) {
+        total += room.roomPrice;
+    }
+};
+
+// Adapter that lets a classic RoomVisitor visit variant rooms. The room type is already known from
+// the variant, so only the visit() call remains virtual; accept() is skipped.
+class RoomVisitorAdapter {
+    RoomVisitor *visitor;
+
+public:
+    RoomVisitorAdapter(RoomVisitor *v) : visitor(v) {}
+
+    void operator()(SingleRoom &room) {
+        visitor->visit(&room);
+    }
+    void operator()(DoubleRoom &room) {
+        visitor->visit(&room);
+    }
+    void operator()(DeluxRoom &room) {
+        visitor->visit(&room);
+    }
+};
+
+// RoomCollection class
+// Rooms live by value in one contiguous vector, so a traversal streams through memory instead of
+// chasing a pointer per room.
+class RoomCollection {
+    vector<Room> rooms;
+
+public:
+    template <typename R>
+    void add(R room) {
+        rooms.emplace_back(move(room));
+    }
+
+    void reserve(size_t count) {
+        rooms.reserve(count);
+    }
+
+    size_t size() {
+        return rooms.size();
+    }
+
+    /**
+     * Applies a static visitor to every room through std::visit.
+     * @param visitor Callable with an overload for each room type
+     */
+    template <typename Visitor>
+    void visitAll(Visitor &visitor) {
+        for (Room &room : rooms) {
+            std::visit(visitor, room);
+        }
+    }
+
+    /**
+     * Applies a classic RoomVisitor to every room through the adapter.
+     * @param visitor Pointer to any RoomVisitor
+     */
+    void accept(RoomVisitor *visitor) {
+        RoomVisitorAdapter adapter(visitor);
+        visitAll(adapter);
+    }
+};
+
+template <typename F>
+double roomsPerSecond(size_t rooms, int passes, F f) {
+    auto start = chrono::steady_clock::now();
+    for (int p = 0; p < passes; p++) {
+        f();
+    }
+    return rooms * passes / chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Totals the prices of `count` rooms of random types with each dispatch path.
+void benchmark(size_t count, int passes) {
+    mt19937 rng(1);
+    vector<unique_ptr<RoomElement>> heapRooms;
+    RoomCollection collection;
+    heapRooms.reserve(count);
+    collection.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        switch (rng() % 3) {
+        case 0:
+            heapRooms.emplace_back(new SingleRoom());
+            collection.add(SingleRoom());
+            break;
+        case 1:
+            heapRooms.emplace_back(new DoubleRoom());
+            collection.add(DoubleRoom());
+            break;
+        default:
+            heapRooms.emplace_back(new DeluxRoom());
+            collection.add(DeluxRoom());
+            break;
+        }
+    }
+
+    RoomTotalVisitor doubleDispatch;
+    double heapRate = roomsPerSecond(count, passes, [&]() {
+        for (auto &room : heapRooms) {
+            room->accept(&doubleDispatch);
+        }
+    });
+    PriceTotal viaVisit;
+    double visitRate = roomsPerSecond(count, passes, [&]() { collection.visitAll(viaVisit); });
+    RoomTotalVisitor adapted;
+    double adapterRate = roomsPerSecond(count, passes, [&]() { collection.accept(&adapted); });
+
+    bool same = viaVisit.total == doubleDispatch.total &&
+                adapted.total == doubleDispatch.total;
+    cout << fixed << setprecision(1);
+    cout << count << " rooms, totals match: " << (same ? "yes" : "NO") << endl;
+    cout << "heap rooms, accept + visit     " << setw(8) << heapRate / 1e6 << " M rooms/s" << endl;
+    cout << "variant rooms, static visitor  " << setw(8) << visitRate / 1e6 << " M rooms/s" << endl;
+    cout << "variant rooms, RoomVisitor     " << setw(8) << adapterRate / 1e6 << " M rooms/s (adapter)" << endl;
+}
+
+int main() {
+    // Rooms stored by value in one collection
+    RoomCollection hotel;
+    hotel.add(SingleRoom());
+    hotel.add(DoubleRoom());
+    hotel.add(DeluxRoom());
+
+    // Existing visitors work through the adapter
+    RoomVisitor *roomPricingVisitor = new RoomPricingVisitor();
+    RoomVisitor *roomMaintainenceVisitor = new RoomMaintainenceVisitor();
+    hotel.accept(roomPricingVisitor);
+    cout << "-----------------" << endl;
+    hotel.accept(roomMaintainenceVisitor);
+    cout << "-----------------" << endl;
+
+    // A static visitor needs no RoomVisitor subclass at all
+    PriceTotal total;
+    hotel.visitAll(total);
+    cout << "Total price of the hotel is " << total.total << endl;
+    cout << "-----------------" << endl;
+
+    benchmark(5000000, 5);
+
+    delete roomPricingVisitor;
+    delete roomMaintainenceVisitor;
+
+    return 0;
+}